@@ -0,0 +1,71 @@
+#include "../include/StorageEngine.hpp"
+#include <chrono>               // Wall-clock timing of the hit loop
+#include <random>               // Uniform page selection
+#include <cstdio>               // printf for the results table
+
+// --- BUFFER HIT LATENCY BENCHMARK ---
+// Fills pools of growing size, then times fetchPage() on a fixed hot set of 256 resident
+// pages. The pages touched stay in the CPU caches whatever the pool size, so only the
+// replacement bookkeeping can grow with the pool: with O(1) LRU relinking the cost per hit
+// should stay flat. The second column replays the same hits against the old LRU, which
+// found the frame with list::remove before moving it to the front, and grows linearly.
+
+// Hit path of the Buffer Manager before O(1) relinking: page table probe, then touch()
+struct ListRemoveLru {
+    unordered_map<int, int> pageTable; // PageID -> frame
+    list<int> lru;                 // Front is Newest, Back is Oldest
+    vector<char> arena;            // Frame memory, one page per frame
+
+    ListRemoveLru(int frames, int pageSize) : arena((size_t)frames * pageSize) {
+        for (int i = 0; i < frames; i++) {
+            pageTable[i + 1] = i;
+            lru.push_front(i);
+        }
+    }
+
+    char* fetchPage(int pageID, int pageSize) {
+        int idx = pageTable.find(pageID)->second;
+        lru.remove(idx);            // Walks the whole list to find the frame
+        lru.push_front(idx);
+        return &arena[(size_t)idx * pageSize];
+    }
+};
+
+int main() {
+    const int capacities[] = {1024, 4096, 16384, 32768};
+    const int hotPages = 256;               // Working set, the same for every pool size
+    const int lookups = 1 << 21;            // Hits timed per pool size
+    const long oldWork = 1L << 24;          // list::remove visits ~frames nodes per hit: cap
+                                            // its hits so every round walks about as far
+
+    printf("%10s %14s %22s\n", "frames", "ns/hit", "ns/hit (list::remove)");
+    for (int cap : capacities) {
+        EngineConfig config;
+        config.bufferFrames = cap;          // Pool sized for this round
+        config.truncate = true;             // Fresh file for every round
+        StorageManager sm("bench_buffer.db", config); // Scratch database file
+        BufferManager bm(sm, config);
+        for (int i = 0; i < cap; i++) bm.allocatePage(); // Pages 1..cap, all resident
+
+        mt19937 rng(42);                    // Same access sequence for every pool size
+        vector<int> ids(lookups);
+        for (int& id : ids) id = 1 + rng() % hotPages;
+
+        unsigned sink = 0;                  // Keeps the loop from being optimized away
+        auto start = chrono::steady_clock::now();
+        for (int id : ids) sink += bm.fetchPage(id)[0];
+        auto stop = chrono::steady_clock::now();
+        double ns = chrono::duration<double, nano>(stop - start).count() / lookups;
+
+        int oldLookups = (int)(oldWork / cap);
+        ListRemoveLru old(cap, config.pageSize);
+        start = chrono::steady_clock::now();
+        for (int i = 0; i < oldLookups; i++) sink += old.fetchPage(ids[i], config.pageSize)[0];
+        stop = chrono::steady_clock::now();
+        double oldNs = chrono::duration<double, nano>(stop - start).count() / oldLookups;
+
+        printf("%10d %14.1f %22.1f%s\n", cap, ns, oldNs, sink ? "*" : "");
+    }
+    remove("bench_buffer.db");              // Clean up the scratch file
+    return 0;
+}
@@ -0,0 +1,75 @@
+#include "../include/ExternalSort.hpp"
+#include <chrono>               // Wall-clock timing of each load
+#include <random>               // Shuffled input for the external sort
+#include <numeric>              // iota for the key array
+#include <cstdio>               // printf for the results table
+
+// --- BULK LOAD BENCHMARK ---
+// Builds the same index three ways and times each one up to a durable checkpoint:
+// key-by-key insert() of sorted keys, bulkLoad() of the sorted array, and bulkLoad()
+// fed by ExternalSorter from shuffled input (sort time included).
+// Usage: bulk_bench [keys] [sortMB]   (default 10M keys, 256MB of sort memory)
+
+struct Result {
+    double sec;                 // Load plus checkpoint
+    int height;                 // Levels from root to leaf
+    int pages;                  // Pages in the database file
+};
+
+template <class Load>
+Result run(Load load) {
+    EngineConfig config;
+    config.setBufferBytes((size_t)256 << 20); // Large pool so insert() is not I/O bound either
+    config.truncate = true;
+    StorageManager sm("bench_bulk.db", config);
+    BufferManager bm(sm, config);
+    BPlusTree tree(bm, config);
+
+    auto start = chrono::steady_clock::now();
+    load(tree);
+    bm.checkpoint();
+    auto stop = chrono::steady_clock::now();
+
+    Result r;
+    r.sec = chrono::duration<double>(stop - start).count();
+    r.height = tree.height();
+    r.pages = bm.getNextPageID();
+    remove("bench_bulk.db");                // Clean up the scratch file
+    return r;
+}
+
+void report(const char* name, int n, const Result& r) {
+    printf("%-22s %9.2f %10.1f %7d %9d\n", name, r.sec, n / r.sec / 1e6, r.height, r.pages);
+}
+
+int main(int argc, char** argv) {
+    int n = argc > 1 ? atoi(argv[1]) : 10000000;
+    size_t sortBytes = (size_t)(argc > 2 ? atoi(argv[2]) : 256) << 20;
+    vector<int> keys(n);
+    iota(keys.begin(), keys.end(), 0);
+
+    printf("%-22s %9s %10s %7s %9s\n", "method", "seconds", "Mkeys/s", "height", "pages");
+    report("insert() loop", n, run([&](BPlusTree& tree) {
+        for (int k : keys) tree.insert(k, k);
+    }));
+    report("bulkLoad sorted", n, run([&](BPlusTree& tree) {
+        ArraySource source(keys.data(), keys.data(), keys.size());
+        tree.bulkLoad(source);
+    }));
+    report("bulkLoad sorted 70%", n, run([&](BPlusTree& tree) {
+        ArraySource source(keys.data(), keys.data(), keys.size());
+        tree.bulkLoad(source, 0.7);         // Room for later inserts before leaves split
+    }));
+
+    vector<int> shuffled = keys;
+    shuffle(shuffled.begin(), shuffled.end(), mt19937(9));
+    size_t runs = 0;
+    report("bulkLoad ext. sort", n, run([&](BPlusTree& tree) {
+        ExternalSorter sorter(sortBytes);
+        for (int k : shuffled) sorter.add(k, k);
+        runs = sorter.runCount();
+        tree.bulkLoad(sorter);
+    }));
+    printf("external sort merged %zu run(s) with %zuMB of memory\n", runs, sortBytes >> 20);
+    return 0;
+}
@@ -0,0 +1,67 @@
+#include "../include/StorageEngine.hpp"
+#include <chrono>               // Wall-clock timing of inserts and lookups
+#include <random>               // Shuffled insert order and random probes
+#include <numeric>              // iota for generating the key set
+#include <cstdio>               // printf for the results table
+
+// --- FANOUT BENCHMARK ---
+// Builds the same index with the old 3-key nodes and with page-filling nodes,
+// then reports tree height, pages used, build time and point-lookup latency.
+// Usage: fanout_bench [keys]   (default 10M; the 3-key tree is capped at 1M keys
+// because it needs roughly one 4KB page per two keys)
+
+struct Result {
+    int height;                 // Levels from root to leaf
+    int pages;                  // Pages allocated in the database file
+    double buildSec;            // Time to insert every key
+    double lookupNs;            // Average find() latency
+};
+
+Result run(int maxKeys, int n) {
+    EngineConfig config;
+    config.maxKeys = maxKeys;               // 3 = old layout, 0 = fill the page
+    config.bufferFrames = 1 << 15;          // 128MB pool
+    config.truncate = true;                 // Fresh file for every run
+    StorageManager sm("bench_fanout.db", config);
+    BufferManager bm(sm, config);
+    BPlusTree tree(bm, config);
+
+    vector<int> keys(n);
+    iota(keys.begin(), keys.end(), 0);
+    shuffle(keys.begin(), keys.end(), mt19937(7)); // Random order: realistic leaf fill
+
+    auto start = chrono::steady_clock::now();
+    for (int k : keys) tree.insert(k);
+    auto built = chrono::steady_clock::now();
+
+    const int probes = 1000000;
+    mt19937 rng(11);
+    int found = 0;
+    auto lookupStart = chrono::steady_clock::now();
+    for (int i = 0; i < probes; i++) found += tree.find(keys[rng() % n]);
+    auto lookupStop = chrono::steady_clock::now();
+    if (found != probes) printf("warning: %d of %d probes missed\n", probes - found, probes);
+
+    Result r;
+    r.height = tree.height();
+    r.pages = bm.getNextPageID();
+    r.buildSec = chrono::duration<double>(built - start).count();
+    r.lookupNs = chrono::duration<double, nano>(lookupStop - lookupStart).count() / probes;
+    remove("bench_fanout.db");              // Clean up the scratch file
+    return r;
+}
+
+int main(int argc, char** argv) {
+    int n = argc > 1 ? atoi(argv[1]) : 10000000;
+
+    int oldN = min(n, 1000000);
+    Result before = run(3, oldN);
+    Result after = run(0, n);
+
+    printf("%-16s %10s %7s %9s %10s %12s\n", "layout", "keys", "height", "pages", "build(s)", "ns/lookup");
+    printf("%-16s %10d %7d %9d %10.2f %12.1f\n", "maxKeys=3", oldN, before.height, before.pages,
+           before.buildSec, before.lookupNs);
+    printf("%-16s %10d %7d %9d %10.2f %12.1f\n", "page-filling", n, after.height, after.pages,
+           after.buildSec, after.lookupNs);
+    return 0;
+}
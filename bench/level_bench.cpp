@@ -0,0 +1,71 @@
+#include "../include/StorageEngine.hpp"
+#include <chrono>               // Wall-clock timing of the lookups
+#include <random>               // Uniform lookup keys, scan start points
+#include <cstdio>               // printf for the results table
+
+// --- TREE-LEVEL PRIORITY BENCHMARK ---
+// A bulk-loaded index far larger than the Buffer Pool serves uniform point lookups
+// interleaved with range scans that stream many leaves through the pool. Every policy runs
+// twice: with the tree's level hints ignored (protectedShare = 0) and with root and internal
+// pages kept in the protected tier (the default 25% of the pool). Misses and latency are
+// those of the lookups alone; one miss per lookup is the floor, since leaves are cold. The
+// file usually sits in the OS page cache, so misses are the figure to compare, not latency.
+// Usage: level_bench [keys] [frames] [rounds]   (default 100M keys, 2048 frames, 100 rounds)
+
+const Replacement policies[] = {Replacement::LRU, Replacement::CLOCK, Replacement::CLOCK_PRO, Replacement::TWO_Q,
+                                 Replacement::ARC};
+
+int main(int argc, char** argv) {
+    int keys = argc > 1 ? atoi(argv[1]) : 100000000;
+    int frames = argc > 2 ? atoi(argv[2]) : 2048;
+    int rounds = argc > 3 ? atoi(argv[3]) : 100;
+
+    EngineConfig config;
+    config.truncate = true;
+    int leaves;
+    {                                       // Build the index once, then reopen it per run
+        StorageManager sm("bench_level.db", config);
+        BufferManager bm(sm, config);
+        BPlusTree tree(bm, config);
+        vector<int> sorted(keys);
+        for (int i = 0; i < keys; i++) sorted[i] = i;
+        ArraySource source(sorted.data(), nullptr, sorted.size());
+        tree.bulkLoad(source);
+        bm.checkpoint();
+        leaves = (keys + BPlusTree::maxFanout(bm.getPageSize()) - 1) / BPlusTree::maxFanout(bm.getPageSize());
+        printf("%d keys, height %d, ~%d leaves, %d frames, %d rounds of 2000 lookups + a %d-leaf scan\n",
+               keys, tree.height(), leaves, frames, rounds, leaves / 64);
+    }
+    config.truncate = false;
+    config.bufferFrames = frames;
+    printf("%-10s %-8s %12s %12s %10s\n", "policy", "hints", "misses/op", "ns/lookup", "protected");
+    for (Replacement policy : policies) {
+        for (double share : {0.0, 0.25}) {
+            config.replacement = policy;
+            config.protectedShare = share;
+            StorageManager sm("bench_level.db", config);
+            BufferManager bm(sm, config);
+            BPlusTree tree(bm, config);
+            mt19937 rng(41);
+            vector<int> probes(2000);
+            long lookups = 0, misses = 0;
+            double ns = 0;
+            for (int round = 0; round < rounds; round++) {
+                for (int& key : probes) key = rng() % keys;
+                long before = bm.stats().misses;
+                auto start = chrono::steady_clock::now();
+                for (int key : probes) tree.find(key);
+                auto stop = chrono::steady_clock::now();
+                ns += chrono::duration<double, nano>(stop - start).count();
+                lookups += probes.size();
+                misses += bm.stats().misses - before;
+                int lo = rng() % (keys - keys / 64);
+                for (BPlusTree::Iterator it = tree.scan(lo, lo + keys / 64); it.valid(); it.next()) {}
+            }
+            printf("%-10s %-8s %12.3f %12.1f %10d\n", bm.policyName(), share > 0 ? "on" : "off",
+                   (double)misses / lookups, ns / lookups, bm.stats().protectedFrames);
+        }
+    }
+    remove("bench_level.db");               // Clean up the scratch file
+    return 0;
+}
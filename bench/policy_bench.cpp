@@ -0,0 +1,180 @@
+#include "../include/ExternalSort.hpp"
+#include <chrono>               // Wall-clock timing of each trace
+#include <random>               // Zipfian page ranks, scan start points
+#include <cmath>                // pow for the Zipf distribution
+#include <cstdio>               // printf for the results table
+
+// --- REPLACEMENT POLICY BENCHMARK ---
+// Replays the same page-access traces through the Buffer Pool under every replacement
+// policy and reports hit rate and fetchPage() cost:
+//   zipf       point accesses with Zipfian skew (s = 0.99) over the whole file
+//   zipf+scan  the same, with 30% of accesses coming from long sequential scans
+//   resident   uniform accesses to pages that all fit in the pool (pure hit path)
+//   phases     alternating recency-heavy phases (a sliding window of recent pages, as
+//              during ingest) and frequency-heavy phases (Zipfian lookups)
+// The 'target' column is the policy's adaptive parameter at the end of the trace (ARC's
+// T1 target p, CLOCK-Pro's cold target); for the phases trace it is also sampled after
+// every phase.
+// A last round runs a real B+ tree: batches of Zipfian point lookups alternate with range
+// scans over an eighth of the keys; hit rate and latency are those of the lookups alone.
+// Usage: policy_bench [accesses] [pages] [frames]   (default 4M, 32768 pages, 2048 frames)
+
+const Replacement policies[] = {Replacement::LRU, Replacement::CLOCK, Replacement::CLOCK_PRO, Replacement::TWO_Q,
+                                 Replacement::ARC};
+
+// Zipfian ranks 0..n-1 by inverse CDF lookup; rank 0 is the most popular
+class Zipf {
+    vector<double> cdf;
+public:
+    Zipf(int n, double s) : cdf(n) {
+        double sum = 0;
+        for (int i = 0; i < n; i++) cdf[i] = (sum += 1.0 / pow(i + 1, s));
+        for (double& c : cdf) c /= sum;
+    }
+    int operator()(mt19937& rng) {
+        double u = uniform_real_distribution<double>(0, 1)(rng);
+        return (int)(lower_bound(cdf.begin(), cdf.end(), u) - cdf.begin());
+    }
+};
+
+vector<int> zipfTrace(int accesses, int pages, double scanShare) {
+    Zipf zipf(pages, 0.99);
+    mt19937 rng(17);
+    vector<int> permute(pages);             // Hot pages are scattered over the file
+    for (int i = 0; i < pages; i++) permute[i] = 1 + i;
+    shuffle(permute.begin(), permute.end(), rng);
+    vector<int> trace;
+    trace.reserve(accesses);
+    const int scanLength = pages / 4;
+    // Chance to start a scan so that 'scanShare' of all accesses end up inside scans
+    double scanStart = scanShare / (scanLength * (1 - scanShare) + scanShare);
+    while ((int)trace.size() < accesses) {
+        if (uniform_real_distribution<double>(0, 1)(rng) < scanStart) {
+            int start = 1 + rng() % (pages - scanLength); // One long range scan over the leaves
+            for (int p = start; p < start + scanLength && (int)trace.size() < accesses; p++) trace.push_back(p);
+        } else {
+            trace.push_back(permute[zipf(rng)]);
+        }
+    }
+    return trace;
+}
+
+// Recency phases read a window of 3/4 of the pool that slides forward one page every four
+// accesses; frequency phases draw Zipfian pages from the whole file
+vector<int> phaseTrace(int accesses, int pages, int frames, int phaseLength) {
+    Zipf zipf(pages, 0.99);
+    mt19937 rng(31);
+    vector<int> trace;
+    trace.reserve(accesses);
+    int window = frames * 3 / 4, base = 0;
+    for (int i = 0; i < accesses; i++) {
+        if ((i / phaseLength) % 2 == 0) {
+            if (i % 4 == 0) base = (base + 1) % (pages - window);
+            trace.push_back(1 + base + rng() % window);
+        } else {
+            trace.push_back(1 + zipf(rng));
+        }
+    }
+    return trace;
+}
+
+vector<int> residentTrace(int accesses, int frames) {
+    mt19937 rng(23);
+    vector<int> trace(accesses);
+    for (int& p : trace) p = 1 + rng() % frames;
+    return trace;
+}
+
+void run(const char* traceName, const vector<int>& trace, int pages, int frames, int phaseLength = 0) {
+    for (Replacement policy : policies) {
+        EngineConfig config;
+        config.bufferFrames = frames;
+        config.replacement = policy;
+        config.truncate = true;
+        StorageManager sm("bench_policy.db", config);
+        BufferManager bm(sm, config);
+        bm.header().nextPageID = pages + 1; // Pages past EOF read back as zeros: no setup writes
+
+        unsigned sink = 0;                  // Keeps the loop from being optimized away
+        vector<int> targets;                // Adaptive parameter after each phase
+        auto start = chrono::steady_clock::now();
+        for (size_t i = 0; i < trace.size(); i++) {
+            sink += bm.fetchPage(trace[i])[0];
+            if (phaseLength && (i + 1) % phaseLength == 0) targets.push_back(bm.stats().adaptiveTarget);
+        }
+        auto stop = chrono::steady_clock::now();
+
+        BufferStats s = bm.stats();
+        double ns = chrono::duration<double, nano>(stop - start).count() / trace.size();
+        printf("%-10s %-10s %9.2f%% %12.1f %8s%s\n", traceName, bm.policyName(),
+               100.0 * s.hits / (s.hits + s.misses), ns,
+               s.adaptiveTarget < 0 ? "-" : to_string(s.adaptiveTarget).c_str(), sink ? "*" : "");
+        if (s.adaptiveTarget >= 0 && !targets.empty()) {
+            printf("%21s target after each phase:", "");
+            for (int t : targets) printf(" %d", t);
+            printf("\n");
+        }
+        remove("bench_policy.db");          // Clean up the scratch file
+    }
+}
+
+// Point lookups sharing the pool with analytic range scans over the leaf chain
+void runTree(int keys, int frames) {
+    EngineConfig config;
+    config.truncate = true;
+    {                                       // Build the index once, then reopen it per policy
+        StorageManager sm("bench_policy.db", config);
+        BufferManager bm(sm, config);
+        BPlusTree tree(bm, config);
+        vector<int> sorted(keys);
+        for (int i = 0; i < keys; i++) sorted[i] = i;
+        ArraySource source(sorted.data(), nullptr, sorted.size());
+        tree.bulkLoad(source);
+        bm.checkpoint();
+    }
+    config.truncate = false;
+    config.bufferFrames = frames;
+    Zipf zipf(keys, 0.99);
+    for (Replacement policy : policies) {
+        config.replacement = policy;
+        StorageManager sm("bench_policy.db", config);
+        BufferManager bm(sm, config);
+        BPlusTree tree(bm, config);
+        mt19937 rng(29);
+        vector<int> probes(5000);
+        long lookups = 0, lookupHits = 0, lookupMisses = 0;
+        double lookupNs = 0;
+        for (int round = 0; round < 100; round++) {
+            for (int& key : probes) key = (int)(((long)zipf(rng) * 7919) % keys); // Hot keys spread out
+            BufferStats before = bm.stats();
+            auto start = chrono::steady_clock::now();
+            for (int key : probes) tree.find(key);
+            auto stop = chrono::steady_clock::now();
+            lookupNs += chrono::duration<double, nano>(stop - start).count();
+            lookups += probes.size();
+            lookupHits += bm.stats().hits - before.hits;
+            lookupMisses += bm.stats().misses - before.misses;
+            int lo = rng() % (keys - keys / 8);
+            for (BPlusTree::Iterator it = tree.scan(lo, lo + keys / 8); it.valid(); it.next()) {}
+        }
+        int target = bm.stats().adaptiveTarget;
+        printf("%-10s %-10s %9.2f%% %12.1f %8s   (per lookup)\n", "tree", bm.policyName(),
+               100.0 * lookupHits / (lookupHits + lookupMisses), lookupNs / lookups,
+               target < 0 ? "-" : to_string(target).c_str());
+    }
+    remove("bench_policy.db");
+}
+
+int main(int argc, char** argv) {
+    int accesses = argc > 1 ? atoi(argv[1]) : 4000000;
+    int pages = argc > 2 ? atoi(argv[2]) : 32768;
+    int frames = argc > 3 ? atoi(argv[3]) : 2048;
+    printf("%d accesses, %d pages, %d frames\n", accesses, pages, frames);
+    printf("%-10s %-10s %10s %12s %8s\n", "trace", "policy", "hit rate", "ns/access", "target");
+    run("zipf", zipfTrace(accesses, pages, 0.0), pages, frames);
+    run("zipf+scan", zipfTrace(accesses, pages, 0.3), pages, frames);
+    run("resident", residentTrace(accesses, frames), pages, frames);
+    run("phases", phaseTrace(accesses, pages, frames, accesses / 8), pages, frames, accesses / 8);
+    runTree(20000000, frames);              // ~39K leaves: the pool holds the inner levels and a few hot leaves
+    return 0;
+}
@@ -0,0 +1,81 @@
+#include "../include/VarKeyTree.hpp"
+#include <chrono>               // Wall-clock timing of inserts and lookups
+#include <random>               // Synthetic URLs, shuffled insert order and random probes
+#include <cstdio>               // printf/snprintf for keys and the results table
+
+// --- KEY COMPRESSION BENCHMARK ---
+// Loads the same URL-like key set into VarKeyTree with plain slotted pages and with
+// prefix compression plus separator truncation, then reports tree height, pages used,
+// build time and point-lookup latency.
+// Usage: prefix_bench [keys]   (default 1M)
+
+struct Result {
+    int height;                 // Levels from root to leaf
+    int pages;                  // Pages allocated in the database file
+    double buildSec;            // Time to insert every key
+    double lookupNs;            // Average find() latency
+};
+
+// Long keys with heavily shared prefixes: host, tenant, date path, then a unique item id
+vector<string> makeUrls(int n) {
+    vector<string> urls;
+    urls.reserve(n);
+    mt19937 rng(3);
+    auto pick = [&rng](unsigned range) { return (unsigned)(rng() % range); };
+    char buf[160];
+    for (int i = 0; i < n; i++) {
+        snprintf(buf, sizeof(buf), "https://shop-%02u.example.com/tenant/%05u/orders/2026/%02u/%02u/item-%010d",
+                 pick(8), pick(2000), 1 + pick(12), 1 + pick(28), i);
+        urls.push_back(buf);
+    }
+    shuffle(urls.begin(), urls.end(), mt19937(7)); // Random order: realistic leaf fill
+    return urls;
+}
+
+Result run(const vector<string>& urls, bool compress) {
+    EngineConfig config;
+    config.compressKeys = compress;
+    config.bufferFrames = 1 << 15;          // 128MB pool: every page stays cached
+    config.truncate = true;                 // Fresh file for every run
+    StorageManager sm("bench_prefix.db", config);
+    BufferManager bm(sm, config);
+    VarKeyTree tree(bm, config);
+
+    auto start = chrono::steady_clock::now();
+    for (size_t i = 0; i < urls.size(); i++) tree.insert(urls[i], (int)i);
+    auto built = chrono::steady_clock::now();
+
+    const int probes = 1000000;
+    mt19937 rng(11);
+    int found = 0;
+    auto lookupStart = chrono::steady_clock::now();
+    for (int i = 0; i < probes; i++) found += tree.find(urls[rng() % urls.size()]);
+    auto lookupStop = chrono::steady_clock::now();
+    if (found != probes) printf("warning: %d of %d probes missed\n", probes - found, probes);
+
+    Result r;
+    r.height = tree.height();
+    r.pages = bm.getNextPageID();
+    r.buildSec = chrono::duration<double>(built - start).count();
+    r.lookupNs = chrono::duration<double, nano>(lookupStop - lookupStart).count() / probes;
+    remove("bench_prefix.db");              // Clean up the scratch file
+    return r;
+}
+
+int main(int argc, char** argv) {
+    int n = argc > 1 ? atoi(argv[1]) : 1000000;
+    vector<string> urls = makeUrls(n);
+    size_t keyBytes = 0;
+    for (const string& u : urls) keyBytes += u.size();
+    printf("%d keys, %.1f bytes per key\n", n, (double)keyBytes / n);
+
+    Result plain = run(urls, false);
+    Result packed = run(urls, true);
+
+    printf("%-16s %7s %9s %10s %12s\n", "layout", "height", "pages", "build(s)", "ns/lookup");
+    printf("%-16s %7d %9d %10.2f %12.1f\n", "plain slotted", plain.height, plain.pages,
+           plain.buildSec, plain.lookupNs);
+    printf("%-16s %7d %9d %10.2f %12.1f\n", "prefix+suffix", packed.height, packed.pages,
+           packed.buildSec, packed.lookupNs);
+    return 0;
+}
@@ -0,0 +1,62 @@
+#include "../include/StorageEngine.hpp"
+#include <chrono>               // Wall-clock timing of the search loops
+#include <random>               // Node contents and probe keys
+#include <set>                  // Distinct keys for each synthetic node
+#include <cstdio>               // printf for the results table
+
+// --- IN-NODE SEARCH BENCHMARK ---
+// Times every KeySearch kernel against the original linear loop on sorted key arrays
+// sized like real nodes (page-filling fanout for 4KB, 16KB and 64KB pages).
+// Usage: search_bench [probes]   (default 4M per kernel and node size)
+
+// Average nanoseconds per search, probing random keys in a pool of random nodes
+double timeKernel(KeySearch::Kernel kernel, const vector<vector<int>>& nodes,
+                  const vector<int>& probes, long& checksum) {
+    auto start = chrono::steady_clock::now();
+    for (size_t i = 0; i < probes.size(); i++) {
+        const vector<int>& node = nodes[i % nodes.size()];
+        checksum += kernel(node.data(), (int)node.size(), probes[i]);
+    }
+    auto stop = chrono::steady_clock::now();
+    return chrono::duration<double, nano>(stop - start).count() / probes.size();
+}
+
+int main(int argc, char** argv) {
+    int probeCount = argc > 1 ? atoi(argv[1]) : 4000000;
+    vector<KeySearch::Kernel> kernels = {KeySearch::linear, KeySearch::binary};
+#ifdef KEY_SEARCH_X86
+    kernels.push_back(KeySearch::sse2);
+    if (__builtin_cpu_supports("avx2")) kernels.push_back(KeySearch::avx2);
+#endif
+    printf("dispatch selects: %s\n", KeySearch::name(KeySearch::best()));
+
+    printf("%-8s", "keys");
+    for (KeySearch::Kernel k : kernels) printf(" %10s", KeySearch::name(k));
+    printf("   (ns/search)\n");
+
+    int sizes[] = {16, 64, BPlusTree::maxFanout(4096), BPlusTree::maxFanout(16384), BPlusTree::maxFanout(65536)};
+    mt19937 rng(5);
+    for (int n : sizes) {
+        vector<vector<int>> nodes(256);    // Enough nodes that searches do not all hit one array
+        for (vector<int>& node : nodes) {
+            set<int> keys;
+            while ((int)keys.size() < n) keys.insert((int)(rng() % 100000000));
+            node.assign(keys.begin(), keys.end());
+        }
+        vector<int> probes(probeCount);
+        for (int& p : probes) p = (int)(rng() % 100000000);
+
+        long checksum = 0, expected = -1;
+        printf("%-8d", n);
+        for (KeySearch::Kernel k : kernels) {
+            long sum = 0;
+            double ns = timeKernel(k, nodes, probes, sum);
+            if (expected != -1 && sum != expected) printf("\nwarning: %s disagrees with linear\n", KeySearch::name(k));
+            expected = sum;
+            checksum += sum;
+            printf(" %10.1f", ns);
+        }
+        printf("   [checksum %ld]\n", checksum);
+    }
+    return 0;
+}
@@ -0,0 +1,42 @@
+#include "../include/StorageEngine.hpp"
+#include <chrono>               // Wall-clock timing of the ingest loops
+#include <cstdio>               // printf for the results table
+
+// --- SPLIT BENCHMARK ---
+// Sequential ingest is the most split-heavy workload: every insert lands in the rightmost
+// leaf, which splits each time it fills. Reports the number of leaf splits, average leaf
+// fill and ingest time per key for small and page-filling fanouts, with the tree cached so
+// no disk I/O is timed.
+// Usage: split_bench [keys]   (default 2M)
+
+int main(int argc, char** argv) {
+    int n = argc > 1 ? atoi(argv[1]) : 2000000;
+    int fanouts[] = {32, 128, 0};           // 0 = fill the page (510 keys at 4KB)
+
+    printf("%-10s %10s %12s %10s %12s\n", "maxKeys", "keys", "leaf splits", "leaf fill", "ns/insert");
+    for (int maxKeys : fanouts) {
+        EngineConfig config;
+        config.maxKeys = maxKeys;
+        config.bufferFrames = 1 << 18;      // 1GB pool: splits, not evictions, dominate
+        config.truncate = true;
+        StorageManager sm("bench_split.db", config);
+        BufferManager bm(sm, config);
+        BPlusTree tree(bm, config);
+
+        auto start = chrono::steady_clock::now();
+        for (int k = 0; k < n; k++) tree.insert(k, k);
+        auto stop = chrono::steady_clock::now();
+
+        int leaves = 0;                     // Every leaf but the first came from a split
+        int page = tree.findLeaf(0);
+        while (page != -1) {
+            leaves++;
+            page = bm.pinPage(page).as<BPlusNode>()->nextLeaf;
+        }
+        double ns = chrono::duration<double, nano>(stop - start).count();
+        int fanout = maxKeys ? maxKeys : BPlusTree::maxFanout(config.pageSize);
+        printf("%-10d %10d %12d %9.1f%% %12.1f\n", fanout, n, leaves - 1, 100.0 * n / ((double)leaves * fanout), ns / n);
+        remove("bench_split.db");          // Clean up the scratch file
+    }
+    return 0;
+}
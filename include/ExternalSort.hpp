@@ -0,0 +1,130 @@
+#ifndef EXTERNAL_SORT_HPP
+#define EXTERNAL_SORT_HPP
+
+#include "StorageEngine.hpp"
+#include <cstdio>       // tmpfile/fread/fwrite for the sorted runs spilled to disk
+#include <queue>        // Min-heap that merges the runs
+
+// --- EXTERNAL MERGE SORT ---
+// Feeds unsorted (key, value) pairs to BPlusTree::bulkLoad(). Pairs are collected in a
+// memory-bounded run; each full run is sorted and spilled to an anonymous temporary file.
+// Reading then merges every run through a min-heap, so input far larger than RAM comes
+// out in ascending key order with one sequential pass over each run.
+// Keys must be unique: bulkLoad() rejects a repeated key.
+class ExternalSorter : public KeyValueSource {
+    struct Pair { int key; int value; };
+
+    // Sequential reader over one sorted run, refilled in fixed-size chunks
+    struct Run {
+        FILE* file = nullptr;      // Spilled run; nullptr for the run still in memory
+        vector<Pair> chunk;        // Pairs read ahead from the file
+        size_t pos = 0;            // Next pair in 'chunk'
+        bool refill() {
+            if (!file) return false;
+            chunk.resize(chunk.capacity());
+            size_t got = fread(chunk.data(), sizeof(Pair), chunk.size(), file);
+            if (got < chunk.size() && ferror(file)) // A short read is the end of the run, unless it failed
+                throw runtime_error(string("reading a sorted run failed: ") + strerror(errno));
+            chunk.resize(got);
+            pos = 0;
+            return got > 0;
+        }
+        const Pair& front() const { return chunk[pos]; }
+        bool advance() { return ++pos < chunk.size() || refill(); } // False once the run is drained
+    };
+
+    size_t runPairs;               // Pairs per in-memory run
+    vector<Pair> buffer;           // Run being collected
+    vector<Pair> scratch;          // Second array the radix sort scatters into
+    vector<FILE*> spilled;         // Sorted runs on disk, in spill order
+    vector<Run> runs;              // Merge cursors, built on the first next()
+    priority_queue<pair<int, int>, vector<pair<int, int>>, greater<pair<int, int>>> heap; // (key, run)
+    bool merging = false;
+    int single = -1;               // The only non-empty run, read directly; -1 when merging
+
+    // LSD radix sort on the key, one byte per pass; passes where every key shares the byte
+    // are skipped. Several times faster than a comparison sort on runs of millions of pairs.
+    void sortPairs(vector<Pair>& pairs) {
+        scratch.resize(pairs.size());
+        for (int shift = 0; shift < 32; shift += 8) {
+            size_t counts[256] = {0};
+            for (const Pair& p : pairs) counts[digit(p.key, shift)]++;
+            if (pairs.empty() || counts[digit(pairs[0].key, shift)] == pairs.size()) continue;
+            size_t offset = 0;
+            for (size_t& c : counts) { size_t n = c; c = offset; offset += n; } // Bucket starts
+            for (const Pair& p : pairs) scratch[counts[digit(p.key, shift)]++] = p;
+            pairs.swap(scratch);
+        }
+    }
+
+    static unsigned digit(int key, int shift) {      // Sign bit flipped: negative keys sort first
+        return (((uint32_t)key ^ 0x80000000u) >> shift) & 0xFF;
+    }
+
+    void spill() {                 // Sort the collected run and write it out
+        sortPairs(buffer);
+        FILE* f = tmpfile();       // Unlinked file: the OS reclaims it even after a crash
+        if (!f) throw runtime_error(string("tmpfile failed: ") + strerror(errno));
+        spilled.push_back(f);
+        if (fwrite(buffer.data(), sizeof(Pair), buffer.size(), f) != buffer.size())
+            throw runtime_error(string("writing a sorted run failed: ") + strerror(errno));
+        buffer.clear();
+    }
+
+    void startMerge() {
+        merging = true;
+        sortPairs(buffer);         // The last run never touches the disk
+        vector<Pair>().swap(scratch); // Merge buffers take the scratch memory instead
+        size_t chunkPairs = max((size_t)4096, runPairs / (spilled.size() + 1)); // Split the budget
+        runs.resize(spilled.size() + 1);
+        for (size_t i = 0; i < spilled.size(); i++) {
+            rewind(spilled[i]);
+            runs[i].file = spilled[i];
+            runs[i].chunk.reserve(chunkPairs);
+            runs[i].refill();
+        }
+        runs.back().chunk.swap(buffer);
+        for (size_t i = 0; i < runs.size(); i++)
+            if (!runs[i].chunk.empty()) heap.push(make_pair(runs[i].front().key, (int)i));
+        if (heap.size() == 1) {    // Nothing to merge: stream the lone run without the heap
+            single = heap.top().second;
+            heap.pop();
+        }
+    }
+
+public:
+    // 'memoryBytes' bounds the RAM used for a run and the radix sort's scratch copy of it
+    ExternalSorter(size_t memoryBytes = (size_t)256 << 20)
+        : runPairs(max((size_t)1, memoryBytes / (2 * sizeof(Pair)))) {}
+    ~ExternalSorter() { for (FILE* f : spilled) fclose(f); }
+    ExternalSorter(const ExternalSorter&) = delete;             // Owns the run files
+    ExternalSorter& operator=(const ExternalSorter&) = delete;
+
+    void add(int key, int value) {
+        if (merging) throw logic_error("ExternalSorter::add() called after reading started");
+        buffer.push_back({key, value});
+        if (buffer.size() == runPairs) spill();
+    }
+
+    size_t runCount() const { return spilled.size() + (buffer.empty() ? 0 : 1); } // Runs to merge
+
+    bool next(int& key, int& value) override {
+        if (!merging) startMerge();
+        if (single != -1) {
+            Run& run = runs[single];
+            key = run.front().key;
+            value = run.front().value;
+            if (!run.advance()) single = -1;
+            return true;
+        }
+        if (heap.empty()) return false;
+        int r = heap.top().second;  // Run holding the smallest remaining key
+        heap.pop();
+        key = runs[r].front().key;
+        value = runs[r].front().value;
+        if (runs[r].advance()) heap.push(make_pair(runs[r].front().key, r));
+        return true;
+    }
+};
+
+#endif
@@ -0,0 +1,105 @@
+#ifndef KEY_SEARCH_HPP
+#define KEY_SEARCH_HPP
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>  // SSE2/AVX2 integer compares for the vectorized kernels
+#define KEY_SEARCH_X86 1
+#endif
+
+// --- IN-NODE KEY SEARCH ---
+// Every kernel returns the lower bound of 'key' in the sorted array keys[0, n):
+// the number of keys smaller than 'key'. The B+ tree calls lowerBound(), which
+// picks the fastest kernel the CPU supports the first time it runs.
+struct KeySearch {
+    typedef int (*Kernel)(const int* keys, int n, int key);
+
+    // Reference loop: one compare and one branch per key
+    static int linear(const int* keys, int n, int key) {
+        int i = 0;
+        while (i < n && keys[i] < key) i++;
+        return i;
+    }
+
+    // Binary search whose halving step compiles to a conditional move instead of a branch
+    static int binary(const int* keys, int n, int key) {
+        int lo = narrow(keys, n, key, 1);
+        return lo + (n == 1 && keys[lo] < key);
+    }
+
+    // Halves [lo, lo + n) without branching until at most 'window' candidates are left.
+    // Keys before 'lo' are all smaller than 'key'; keys from 'lo + n' on are not.
+    static int narrow(const int* keys, int& n, int key, int window) {
+        int lo = 0;
+        while (n > window) {
+            int half = n / 2;
+            lo = keys[lo + half - 1] < key ? lo + half : lo;
+            n -= half;
+        }
+        return lo;
+    }
+
+#ifdef KEY_SEARCH_X86
+    // Binary search down to a few vectors, then count the smaller keys in that window:
+    // the keys are sorted, so the count is exactly the lower bound's offset in the window.
+    // Compare masks (-1 per smaller key) are summed in a register, so no popcount is needed.
+    // SSE2 is part of every x86-64 CPU, so this is the vector fallback when AVX2 is missing.
+    static int sse2(const int* keys, int n, int key) {
+        int lo = narrow(keys, n, key, 16);
+        const int* window = keys + lo;
+        __m128i needle = _mm_set1_epi32(key);
+        __m128i count = _mm_setzero_si128();
+        int i = 0;
+        for (; i + 4 <= n; i += 4)
+            count = _mm_sub_epi32(count, _mm_cmpgt_epi32(needle, _mm_loadu_si128((const __m128i*)(window + i))));
+        count = _mm_add_epi32(count, _mm_shuffle_epi32(count, _MM_SHUFFLE(1, 0, 3, 2))); // Horizontal sum
+        count = _mm_add_epi32(count, _mm_shuffle_epi32(count, _MM_SHUFFLE(2, 3, 0, 1)));
+        lo += _mm_cvtsi128_si32(count);
+        for (; i < n; i++) lo += window[i] < key;
+        return lo;
+    }
+
+    __attribute__((target("avx2")))
+    static int avx2(const int* keys, int n, int key) {
+        int lo = narrow(keys, n, key, 32);
+        const int* window = keys + lo;
+        __m256i needle = _mm256_set1_epi32(key);
+        __m256i count = _mm256_setzero_si256();
+        int i = 0;
+        for (; i + 8 <= n; i += 8)
+            count = _mm256_sub_epi32(count, _mm256_cmpgt_epi32(needle, _mm256_loadu_si256((const __m256i*)(window + i))));
+        __m128i half = _mm_add_epi32(_mm256_castsi256_si128(count), _mm256_extracti128_si256(count, 1));
+        half = _mm_add_epi32(half, _mm_shuffle_epi32(half, _MM_SHUFFLE(1, 0, 3, 2)));
+        half = _mm_add_epi32(half, _mm_shuffle_epi32(half, _MM_SHUFFLE(2, 3, 0, 1)));
+        lo += _mm_cvtsi128_si32(half);
+        for (; i < n; i++) lo += window[i] < key;
+        return lo;
+    }
+#endif
+
+    // Kernel lowerBound() uses on this CPU
+    static Kernel best() {
+#ifdef KEY_SEARCH_X86
+        if (__builtin_cpu_supports("avx2")) return avx2;
+        return sse2;
+#else
+        return binary;
+#endif
+    }
+
+    static const char* name(Kernel k) {
+        if (k == linear) return "linear";
+        if (k == binary) return "binary";
+#ifdef KEY_SEARCH_X86
+        if (k == sse2) return "sse2";
+        if (k == avx2) return "avx2";
+#endif
+        return "unknown";
+    }
+
+    static int lowerBound(const int* keys, int n, int key) {
+        static const Kernel kernel = best(); // CPU features are probed once
+        return kernel(keys, n, key);
+    }
+};
+
+#endif
@@ -0,0 +1,569 @@
+#ifndef REPLACEMENT_POLICY_HPP
+#define REPLACEMENT_POLICY_HPP
+
+#include <vector>       // The frame pool shared with the Buffer Manager
+#include <list>         // Recency lists of LRU and the CLOCK-Pro page clock
+#include <unordered_map> // CLOCK-Pro, 2Q and ARC: history of recently evicted pages by PageID
+#include <memory>       // unique_ptr returned by makePolicy()
+#include <algorithm>    // min/max when adapting CLOCK-Pro's cold target
+
+using namespace std;
+
+// Tree-level hint for a buffered page (BufferManager::setPriority). Root and internal pages
+// are few and sit on every descent, so the Buffer Manager keeps them in a protected tier
+// outside the replacement policy; leaves and all other pages stay NORMAL.
+enum class PagePriority { NORMAL, INTERNAL, ROOT };
+
+// --- BUFFER FRAME ---
+// Structure representing a slot in RAM
+struct Frame {
+    int pageID = -1;               // ID of the page currently in RAM; -1 indicates empty
+    bool dirty = false;            // Flag: True if data was modified but not yet saved to disk
+    int pinCount = 0;              // Active PageGuards on this frame; pinned frames are never evicted
+    bool referenced = false;       // CLOCK reference bit: set by a hit, cleared by the sweeping hand
+    PagePriority priority = PagePriority::NORMAL; // Non-NORMAL frames are in the protected tier
+    char* data = nullptr;          // The page-sized memory buffer, carved out of the pool arena
+};
+
+// Replacement policies the Buffer Manager can be started with (EngineConfig::replacement)
+enum class Replacement { LRU, CLOCK, CLOCK_PRO, TWO_Q, ARC };
+
+// --- REPLACEMENT POLICY INTERFACE ---
+// Decides which frame to reuse when the pool is full. The Buffer Manager reports every hit
+// and every page it loads; victim() picks an unpinned frame and forgets its page, after
+// which the Buffer Manager writes it back (if dirty) and refills the frame with the
+// requested page; if that write fails, the page stays and the frame comes back through
+// onLoad(). Frames moved to the protected tier are handed over with onRemove() and
+// come back through onLoad().
+class ReplacementPolicy {
+protected:
+    vector<Frame>& pool;           // Frames owned by the Buffer Manager; pinCount is read here
+
+public:
+    ReplacementPolicy(vector<Frame>& frames) : pool(frames) {}
+    virtual ~ReplacementPolicy() {}
+
+    virtual const char* name() const = 0;
+    virtual void onHit(int frame) = 0;      // Requested page was already in 'frame'
+    virtual void onLoad(int frame) = 0;     // 'frame' was just filled with pool[frame].pageID
+    virtual void onRemove(int frame) = 0;   // Stop tracking 'frame'; its page stays resident
+    virtual int victim(int pageID) = 0;     // Frame to evict for 'pageID'; -1 when every frame is pinned
+    virtual int adaptiveTarget() const { return -1; } // Self-tuned parameter, -1 for fixed policies
+    virtual bool remembers(int) const { return false; } // PageID is in the history of evicted pages
+    // Appends up to 'n' tracked frames, in about the order victim() would reach them, without
+    // changing any state. The background writer cleans these ahead of eviction.
+    virtual void evictionCandidates(vector<int>& out, size_t n) const = 0;
+};
+
+// --- LRU ---
+// Exact recency order in a linked list: every hit relinks the frame at the front, and the
+// victim is the unpinned frame closest to the back.
+class LruPolicy : public ReplacementPolicy {
+    list<int> lru;                 // Tracking usage: Front is Newest, Back is Oldest
+    vector<list<int>::iterator> pos; // Each frame's node in 'lru', kept for O(1) relinking
+
+public:
+    LruPolicy(vector<Frame>& frames) : ReplacementPolicy(frames), pos(frames.size()) {}
+
+    const char* name() const override { return "LRU"; }
+
+    void onHit(int frame) override { lru.splice(lru.begin(), lru, pos[frame]); } // Move to the front
+
+    void onLoad(int frame) override {
+        lru.push_front(frame);
+        pos[frame] = lru.begin();
+    }
+
+    void onRemove(int frame) override { lru.erase(pos[frame]); }
+
+    void evictionCandidates(vector<int>& out, size_t n) const override {
+        for (auto it = lru.rbegin(); it != lru.rend() && n > 0; ++it, n--) out.push_back(*it);
+    }
+
+    int victim(int) override {
+        for (auto it = lru.rbegin(); it != lru.rend(); ++it) { // From the least recently used end...
+            if (pool[*it].pinCount > 0) continue; // ...skipping frames someone still holds
+            int frame = *it;
+            lru.erase(pos[frame]);
+            return frame;
+        }
+        return -1;
+    }
+};
+
+// --- CLOCK ---
+// Second-chance approximation of LRU: a hit only sets the frame's reference bit, so there
+// is no shared list to update. The hand sweeps the frames in order, clearing set bits and
+// evicting the first unpinned frame whose bit is already clear.
+class ClockPolicy : public ReplacementPolicy {
+    size_t hand = 0;               // Next frame the clock hand examines
+    vector<bool> tracked;          // Frames on the clock; the hand skips the protected tier
+
+public:
+    ClockPolicy(vector<Frame>& frames) : ReplacementPolicy(frames), tracked(frames.size(), false) {}
+
+    const char* name() const override { return "CLOCK"; }
+    void onHit(int frame) override { pool[frame].referenced = true; }
+    void onLoad(int frame) override { pool[frame].referenced = tracked[frame] = true; }
+    void onRemove(int frame) override { tracked[frame] = false; }
+
+    void evictionCandidates(vector<int>& out, size_t n) const override {
+        for (int pass = 0; pass < 2; pass++) { // Clear bits ahead of the hand first, then set ones
+            for (size_t step = 0; step < pool.size() && n > 0; step++) {
+                size_t frame = (hand + step) % pool.size();
+                if (tracked[frame] && pool[frame].referenced == (pass == 1)) {
+                    out.push_back(frame);
+                    n--;
+                }
+            }
+        }
+    }
+
+    int victim(int) override {
+        for (size_t step = 0; step < 2 * pool.size(); step++) { // Two sweeps clear every bit
+            int frame = hand;
+            hand = (hand + 1) % pool.size();
+            if (!tracked[frame] || pool[frame].pinCount > 0) continue;
+            if (pool[frame].referenced) {
+                pool[frame].referenced = false; // Second chance
+                continue;
+            }
+            return frame;
+        }
+        return -1;
+    }
+};
+
+// --- CLOCK-PRO ---
+// CLOCK with reuse distance (Jiang, Chen, Zhang; USENIX ATC 2005). Resident pages are hot
+// or cold; a newly loaded page is cold and starts a "test period". A cold page referenced
+// again during its test period becomes hot, so pages touched once (e.g. by a scan) never
+// displace the hot set. Evicted cold pages stay in the clock as non-resident entries until
+// their test period ends; a miss on one of them grows the cold target, while test periods
+// that expire unused shrink it. Hits only set a reference bit, as in CLOCK.
+// All pages sit on one circular list; new pages are inserted just behind the hot hand.
+class ClockProPolicy : public ReplacementPolicy {
+    struct Entry {
+        int pageID;
+        int frame;                 // Frame holding the page; -1 for a non-resident cold page
+        bool hot;                  // Hot pages are evicted only after being demoted to cold
+        bool test;                 // Cold page in its test period
+    };
+    typedef list<Entry>::iterator Pos;
+
+    list<Entry> clock;             // The circular list, swept in iteration order
+    Pos handHot, handCold, handTest; // Demote hot pages / evict cold pages / end test periods
+    unordered_map<int, Pos> ghosts; // Non-resident test entries by PageID
+    vector<Pos> entry;             // Each resident frame's entry in the clock
+    vector<bool> handedOff;        // Frames given up with onRemove() and not yet loaded again
+    int capacity;                  // Frames the policy manages (m): the pool minus the protected tier
+    int coldTarget;                // Adaptive number of frames for cold pages (mc)
+    int minCold;                   // Floor of the cold target
+    int hotCount = 0;              // Resident hot pages
+    int coldCount = 0;             // Resident cold pages
+
+    void advance(Pos& hand) {      // Move a hand one entry forward, wrapping around
+        if (++hand == clock.end()) hand = clock.begin();
+    }
+
+    void clearHands(Pos it) {      // Entry is about to move or vanish: step hands off it
+        if (handHot == it) advance(handHot);
+        if (handCold == it) advance(handCold);
+        if (handTest == it) advance(handTest);
+    }
+
+    Pos insertAtHead(const Entry& e) { // Most recent position: just behind the hot hand
+        if (clock.empty()) {
+            clock.push_back(e);
+            handHot = handCold = handTest = clock.begin();
+            return clock.begin();
+        }
+        return clock.insert(handHot, e);
+    }
+
+    void moveToHead(Pos it) {
+        if (clock.size() == 1) return;
+        clearHands(it);
+        clock.splice(handHot, clock, it);
+    }
+
+    void erase(Pos it) {
+        if (clock.size() == 1) { clock.clear(); return; }
+        clearHands(it);
+        clock.erase(it);
+    }
+
+    // A test period expired unused. The target never drops below 1% of the pool: with fewer
+    // cold pages the cold hand would walk most of the clock to find each victim.
+    void shrinkCold() { coldTarget = max(minCold, coldTarget - 1); }
+
+    void removeGhost(Pos it) {
+        ghosts.erase(it->pageID);
+        erase(it);
+    }
+
+    // Demotes one hot page to cold; cold pages passed on the way end their test period.
+    // Returns false if there was no hot page to demote.
+    bool runHandHot() {
+        for (size_t step = 0; step < 2 * clock.size() + 1 && hotCount > 0; step++) {
+            Pos it = handHot;
+            Entry& e = *it;
+            if (e.hot) {
+                Frame& f = pool[e.frame];
+                if (f.referenced) {
+                    f.referenced = false;
+                    advance(handHot);
+                } else {           // Not used since the last sweep: demote
+                    e.hot = false;
+                    e.test = false;
+                    hotCount--;
+                    coldCount++;
+                    advance(handHot);
+                    return true;
+                }
+            } else if (e.frame == -1) {
+                shrinkCold();
+                removeGhost(it);   // Steps the hand forward
+            } else {
+                if (e.test) {
+                    e.test = false;
+                    shrinkCold();
+                }
+                advance(handHot);
+            }
+        }
+        return false;
+    }
+
+    void balanceHot() {            // Keep the hot pages within the frames not reserved for cold ones
+        while (hotCount > capacity - coldTarget && runHandHot()) {}
+    }
+
+    // Bounds the non-resident entries to the pool size by expiring the oldest test period
+    void runHandTest() {
+        for (size_t step = 0; step < clock.size() + 1; step++) {
+            Pos it = handTest;
+            Entry& e = *it;
+            if (e.frame == -1) {
+                shrinkCold();
+                removeGhost(it);
+                return;
+            }
+            if (!e.hot && e.test) {
+                e.test = false;
+                shrinkCold();
+            }
+            advance(handTest);
+        }
+    }
+
+public:
+    ClockProPolicy(vector<Frame>& frames)
+        : ReplacementPolicy(frames), entry(frames.size()), handedOff(frames.size(), false), capacity((int)frames.size()),
+          coldTarget(max(1, (int)frames.size() / 100)), minCold(coldTarget) {}
+
+    const char* name() const override { return "CLOCK-Pro"; }
+    int adaptiveTarget() const override { return coldTarget; } // Frames currently reserved for cold pages
+    bool remembers(int pageID) const override { return ghosts.count(pageID) > 0; } // Test period running
+
+    void onHit(int frame) override { pool[frame].referenced = true; }
+
+    void onLoad(int frame) override {
+        int pageID = pool[frame].pageID;
+        pool[frame].referenced = false;
+        if (handedOff[frame]) {      // Frame returns from the protected tier
+            handedOff[frame] = false;
+            capacity++;
+        }
+        auto ghost = ghosts.find(pageID);
+        if (ghost != ghosts.end()) { // Reused within its test period: a hot page
+            removeGhost(ghost->second);
+            coldTarget = min(max(1, capacity - 1), coldTarget + 1);
+            entry[frame] = insertAtHead(Entry{pageID, frame, true, false});
+            hotCount++;
+            balanceHot();
+        } else {                     // First access: cold, on trial
+            entry[frame] = insertAtHead(Entry{pageID, frame, false, true});
+            coldCount++;
+        }
+    }
+
+    void onRemove(int frame) override { // Leaves no test entry: the page is still resident
+        Pos it = entry[frame];
+        if (it->hot) hotCount--;
+        else coldCount--;
+        erase(it);
+        handedOff[frame] = true;     // Size the hot/cold split to the frames still managed
+        capacity--;
+        coldTarget = max(minCold, min(coldTarget, capacity - 1));
+    }
+
+    void evictionCandidates(vector<int>& out, size_t n) const override {
+        if (clock.empty()) return;
+        for (int pass = 0; pass < 2; pass++) { // Cold pages from the cold hand, then hot pages
+            list<Entry>::const_iterator it = pass == 0 ? handCold : handHot;
+            for (size_t step = 0; step < clock.size() && n > 0; step++) {
+                if (it->frame != -1 && it->hot == (pass == 1)) {
+                    out.push_back(it->frame);
+                    n--;
+                }
+                if (++it == clock.end()) it = clock.begin();
+            }
+        }
+    }
+
+    int victim(int) override {
+        int pinnedSkips = 0;         // Pinned cold pages passed since the last demotion
+        for (size_t step = 0; step < 4 * clock.size() + 4; step++) {
+            if (coldCount == 0 || pinnedSkips >= coldCount) { // No evictable cold page: demote a hot one
+                if (!runHandHot()) break;
+                pinnedSkips = 0;
+                continue;
+            }
+            Pos it = handCold;
+            Entry& e = *it;
+            if (e.hot || e.frame == -1 || pool[e.frame].pinCount > 0) {
+                if (!e.hot && e.frame != -1) pinnedSkips++;
+                advance(handCold);
+                continue;
+            }
+            Frame& f = pool[e.frame];
+            if (f.referenced) {      // Used since it was loaded or last passed
+                f.referenced = false;
+                if (e.test) {        // Reuse distance shorter than the hot pages': promote
+                    e.hot = true;
+                    coldCount--;
+                    hotCount++;
+                    moveToHead(it);
+                    balanceHot();
+                } else {             // Give it a fresh test period
+                    e.test = true;
+                    moveToHead(it);
+                }
+                continue;
+            }
+            int frame = e.frame;
+            coldCount--;
+            if (e.test) {            // Keep the page's history until its test period ends
+                e.frame = -1;
+                ghosts[e.pageID] = it;
+                advance(handCold);
+                if ((int)ghosts.size() > capacity) runHandTest();
+            } else {
+                erase(it);
+            }
+            return frame;
+        }
+        return -1;
+    }
+};
+
+// --- 2Q ---
+// Scan-resistant LRU (Johnson and Shasha, VLDB 1994). A page seen for the first time enters
+// A1in, a FIFO holding about a quarter of the frames; hits there do not promote it, so the
+// burst of references from one scan or one descent counts once. Pages evicted from A1in are
+// remembered in A1out, a FIFO of PageIDs only. A page requested again while still listed
+// in A1out has proven reuse and is loaded into Am, the LRU list of hot pages. Am is only
+// evicted from when A1in is at or below its target size, so a long range scan cycles
+// through A1in without pushing the root and internal nodes out of Am.
+class TwoQPolicy : public ReplacementPolicy {
+    list<int> a1in;                // First-time pages, newest at the front
+    list<int> am;                  // Re-referenced pages in LRU order, newest at the front
+    vector<list<int>::iterator> pos; // Each frame's node in whichever queue holds it
+    vector<bool> inAm;             // Which queue each resident frame is on
+    list<int> a1out;               // PageIDs recently evicted from A1in, newest at the front
+    unordered_map<int, list<int>::iterator> ghosts; // PageID -> node in 'a1out'
+    size_t inTarget;               // Kin: A1in size above which A1in gives up the victim
+    size_t outLimit;               // Kout: PageIDs remembered in A1out
+
+    // Oldest unpinned frame of a queue, unlinked from it; -1 if all of them are pinned
+    int takeOldest(list<int>& queue) {
+        for (auto it = queue.rbegin(); it != queue.rend(); ++it) {
+            if (pool[*it].pinCount > 0) continue;
+            int frame = *it;
+            queue.erase(pos[frame]);
+            return frame;
+        }
+        return -1;
+    }
+
+    void remember(int pageID) {    // Record an A1in eviction in A1out
+        a1out.push_front(pageID);
+        ghosts[pageID] = a1out.begin();
+        if (a1out.size() > outLimit) {
+            ghosts.erase(a1out.back());
+            a1out.pop_back();
+        }
+    }
+
+public:
+    TwoQPolicy(vector<Frame>& frames)
+        : ReplacementPolicy(frames), pos(frames.size()), inAm(frames.size(), false),
+          inTarget(max((size_t)1, frames.size() / 4)), outLimit(max((size_t)1, frames.size() / 2)) {}
+
+    const char* name() const override { return "2Q"; }
+    bool remembers(int pageID) const override { return ghosts.count(pageID) > 0; } // Listed in A1out
+
+    void onHit(int frame) override {
+        if (inAm[frame]) am.splice(am.begin(), am, pos[frame]); // A1in hits are correlated: no change
+    }
+
+    void onLoad(int frame) override {
+        auto ghost = ghosts.find(pool[frame].pageID);
+        inAm[frame] = ghost != ghosts.end();
+        if (inAm[frame]) {           // Second use after leaving A1in: hot
+            a1out.erase(ghost->second);
+            ghosts.erase(ghost);
+            am.push_front(frame);
+            pos[frame] = am.begin();
+        } else {
+            a1in.push_front(frame);
+            pos[frame] = a1in.begin();
+        }
+    }
+
+    void onRemove(int frame) override { (inAm[frame] ? am : a1in).erase(pos[frame]); }
+
+    void evictionCandidates(vector<int>& out, size_t n) const override {
+        bool inFirst = a1in.size() > inTarget || am.empty(); // Same queue order as victim()
+        for (const list<int>* queue : {inFirst ? &a1in : &am, inFirst ? &am : &a1in})
+            for (auto it = queue->rbegin(); it != queue->rend() && n > 0; ++it, n--) out.push_back(*it);
+    }
+
+    int victim(int) override {
+        bool fromIn = a1in.size() > inTarget || am.empty();
+        int frame = takeOldest(fromIn ? a1in : am);
+        if (frame == -1) {           // Preferred queue fully pinned: fall back to the other one
+            fromIn = !fromIn;
+            frame = takeOldest(fromIn ? a1in : am);
+        }
+        if (frame != -1 && fromIn) remember(pool[frame].pageID);
+        return frame;
+    }
+};
+
+// --- ARC ---
+// Adaptive Replacement Cache (Megiddo and Modha, FAST 2003). Resident pages are split into
+// T1, seen once recently, and T2, seen at least twice; both are LRU lists. B1 and B2 are
+// ghost lists of the PageIDs last evicted from T1 and T2. A miss on a B1 ghost means T1 was
+// too small, so the target size p of T1 grows; a miss on a B2 ghost shrinks it. Evictions
+// take the LRU page of T1 while T1 is larger than p, otherwise of T2, so the split between
+// recency and frequency follows the workload. p is reported as the adaptive target.
+class ArcPolicy : public ReplacementPolicy {
+    enum Where { T1, T2, B1, B2 };
+    list<int> lists[4];            // T1/T2 hold frames, B1/B2 hold PageIDs; newest at the front
+    vector<list<int>::iterator> pos; // Each resident frame's node in T1 or T2
+    vector<Where> where;           // Which of T1/T2 each resident frame is on
+    unordered_map<int, pair<Where, list<int>::iterator>> ghosts; // PageID -> node in B1 or B2
+    vector<bool> handedOff;        // Frames given up with onRemove() and not yet loaded again
+    int capacity;                  // Frames the policy manages (c): the pool minus the protected tier
+    int target = 0;                // p: adaptive target size of T1
+
+    int size(Where w) const { return (int)lists[w].size(); }
+
+    void dropOldestGhost(Where w) {
+        ghosts.erase(lists[w].back());
+        lists[w].pop_back();
+    }
+
+    // Oldest unpinned frame of T1 or T2, unlinked from it; -1 if all of them are pinned
+    int takeOldest(Where w) {
+        for (auto it = lists[w].rbegin(); it != lists[w].rend(); ++it) {
+            if (pool[*it].pinCount > 0) continue;
+            int frame = *it;
+            lists[w].erase(pos[frame]);
+            return frame;
+        }
+        return -1;
+    }
+
+public:
+    ArcPolicy(vector<Frame>& frames)
+        : ReplacementPolicy(frames), pos(frames.size()), where(frames.size(), T1), handedOff(frames.size(), false),
+          capacity((int)frames.size()) {}
+
+    const char* name() const override { return "ARC"; }
+    int adaptiveTarget() const override { return target; }
+    bool remembers(int pageID) const override { return ghosts.count(pageID) > 0; } // Listed in B1 or B2
+
+    void onHit(int frame) override {   // Any hit makes the page frequent: MRU end of T2
+        list<int>& t2 = lists[T2];
+        t2.splice(t2.begin(), lists[where[frame]], pos[frame]);
+        where[frame] = T2;
+    }
+
+    void onLoad(int frame) override {
+        if (handedOff[frame]) {        // Frame returns from the protected tier
+            handedOff[frame] = false;
+            capacity++;
+        }
+        auto ghost = ghosts.find(pool[frame].pageID);
+        Where w = T1;
+        if (ghost != ghosts.end()) {   // Seen before it was evicted: frequent
+            lists[ghost->second.first].erase(ghost->second.second);
+            ghosts.erase(ghost);
+            w = T2;
+        }
+        lists[w].push_front(frame);
+        pos[frame] = lists[w].begin();
+        where[frame] = w;
+    }
+
+    void onRemove(int frame) override {
+        lists[where[frame]].erase(pos[frame]);
+        handedOff[frame] = true;       // The cache c shrinks by the frame
+        capacity--;
+        target = min(target, capacity);
+    }
+
+    void evictionCandidates(vector<int>& out, size_t n) const override {
+        Where first = size(T1) > 0 && size(T1) > target ? T1 : T2; // REPLACE's choice, then the other
+        for (Where w : {first, first == T1 ? T2 : T1})
+            for (auto it = lists[w].rbegin(); it != lists[w].rend() && n > 0; ++it, n--) out.push_back(*it);
+    }
+
+    int victim(int pageID) override {
+        auto ghost = ghosts.find(pageID);
+        bool inB2 = false;
+        if (ghost != ghosts.end()) {   // Adapt p toward the list that would have kept the page
+            if (ghost->second.first == B1) target = min(capacity, target + max(size(B2) / size(B1), 1));
+            else target = max(0, target - max(size(B1) / size(B2), 1));
+            inB2 = ghost->second.first == B2;
+        } else if (size(T1) + size(B1) >= capacity) { // L1 is full: make room in it
+            if (size(B1) > 0) {
+                dropOldestGhost(B1);
+            } else {                   // T1 fills the cache: evict its LRU page without a ghost
+                int frame = takeOldest(T1);
+                if (frame != -1) return frame;
+            }
+        } else if (size(T1) + size(T2) + size(B1) + size(B2) >= 2 * capacity && size(B2) > 0) {
+            dropOldestGhost(B2);       // Directory is full: forget the oldest frequent ghost
+        }
+        // REPLACE: T1 gives up a page while it is over its target, otherwise T2 does
+        Where from = size(T1) > 0 && (size(T1) > target || (inB2 && size(T1) == target)) ? T1 : T2;
+        int frame = takeOldest(from);
+        if (frame == -1) {             // Every frame on that list is pinned: try the other one
+            from = from == T1 ? T2 : T1;
+            frame = takeOldest(from);
+        }
+        if (frame == -1) return -1;
+        Where ghostList = from == T1 ? B1 : B2;
+        int evicted = pool[frame].pageID;
+        lists[ghostList].push_front(evicted);
+        ghosts[evicted] = make_pair(ghostList, lists[ghostList].begin());
+        return frame;
+    }
+};
+
+// Builds the policy selected in the engine configuration
+inline unique_ptr<ReplacementPolicy> makePolicy(Replacement kind, vector<Frame>& frames) {
+    switch (kind) {
+        case Replacement::CLOCK: return unique_ptr<ReplacementPolicy>(new ClockPolicy(frames));
+        case Replacement::CLOCK_PRO: return unique_ptr<ReplacementPolicy>(new ClockProPolicy(frames));
+        case Replacement::TWO_Q: return unique_ptr<ReplacementPolicy>(new TwoQPolicy(frames));
+        case Replacement::ARC: return unique_ptr<ReplacementPolicy>(new ArcPolicy(frames));
+        default: return unique_ptr<ReplacementPolicy>(new LruPolicy(frames));
+    }
+}
+
+#endif
@@ -1,205 +1,1337 @@
-#ifndef STORAGE_ENGINE_HPP
-#define STORAGE_ENGINE_HPP
-
-#include <iostream>     // Provides standard input/output streams (cout)
-#include <fstream>      // Provides file stream classes for binary disk I/O
-#include <vector>       // Used to manage the collection of frames in the Buffer Pool
-#include <unordered_map> // Used for the Page Table to achieve O(1) page lookups in RAM
-#include <list>         // Used to implement the LRU (Least Recently Used) tracking list
-#include <cstring>      // Provides memory manipulation functions like memset and memcpy
-#include <algorithm>    // Provides the sort function used during B+ Tree node splitting
-
-using namespace std;    // Allows using standard library members without the std:: prefix
-
-// --- GLOBAL SYSTEM CONFIGURATIONS ---
-const int PAGE_SIZE = 4096;        // 4KB: The standard block size for disk/RAM data transfer
-const int BUFFER_CAPACITY = 3;     // Limits RAM to 3 pages to force eviction logic visibility
-const int MAX_KEYS = 3;            // Max keys per node; small value triggers splits quickly
-
-// --- STORAGE MANAGER (DISK LAYER) ---
-// Manages the physical byte-offsets within the binary database file
-class StorageManager {
-    string fileName;               // The string name of the database file on disk
-    fstream dbFile;                // The actual stream object for reading and writing bits
-public:
-    StorageManager(string name) : fileName(name) {
-        // Open file: in/out permission, binary mode, and trunc (wipes file for a clean demo)
-        dbFile.open(fileName, ios::in | ios::out | ios::binary | ios::trunc);
-        if (!dbFile.is_open()) {   // If the file fails to open (doesn't exist):
-            dbFile.open(fileName, ios::out | ios::binary); // Create the file using 'out'
-            dbFile.close();        // Close it immediately to reset the stream state
-            dbFile.open(fileName, ios::in | ios::out | ios::binary); // Re-open for R/W access
-        }
-    }
-    void writeDisk(int pageID, const char* data) {
-        cout << "[DISK] Writing Page " << pageID << " to " << fileName << "..." << endl;
-        dbFile.seekp(pageID * PAGE_SIZE, ios::beg); // Move "put" pointer to (pageID * 4096)
-        dbFile.write(data, PAGE_SIZE);             // Write 4096 raw bytes to the disk
-        dbFile.flush();                            // Force the OS to physically write to the drive
-    }
-    void readDisk(int pageID, char* buffer) {
-        cout << "[DISK] Reading Page " << pageID << " from disk..." << endl;
-        dbFile.seekg(pageID * PAGE_SIZE, ios::beg); // Move "get" pointer to start of PageID
-        dbFile.read(buffer, PAGE_SIZE);            // Read 4096 bytes into the RAM buffer
-    }
-};
-
-// --- BUFFER MANAGER (RAM LAYER) ---
-// Structure representing a slot in RAM
-struct Frame {
-    int pageID = -1;               // ID of the page currently in RAM; -1 indicates empty
-    bool dirty = false;            // Flag: True if data was modified but not yet saved to disk
-    char data[PAGE_SIZE];          // The actual 4096-byte memory buffer
-};
-
-class BufferManager {
-    StorageManager& sm;            // Reference to the Storage Layer for Disk I/O
-    vector<Frame> pool;            // The Buffer Pool: a vector of RAM frames
-    unordered_map<int, int> pageTable; // Fast mapping: PageID -> index in 'pool' vector
-    list<int> lru;                 // Tracking usage: Front is Newest, Back is Oldest
-
-public:
-    int nextPageID = 0;            // Counter to assign unique IDs to new database pages
-    BufferManager(StorageManager& s) : sm(s), pool(BUFFER_CAPACITY) {}
-
-    char* fetchPage(int pageID) {
-        if (pageTable.count(pageID)) { // CASE: Page is already in RAM (Buffer Hit)
-            cout << "[BUFFER] Hit! Page " << pageID << " found in RAM." << endl;
-            touch(pageTable[pageID]);  // Update its priority to "Most Recently Used"
-            return pool[pageTable[pageID]].data; // Return pointer to the data
-        }
-        // CASE: Page is not in RAM (Buffer Miss)
-        cout << "[BUFFER] Miss! Page " << pageID << " not in RAM." << endl;
-        int frameIdx = evict();        // Find or create a free frame in RAM
-        sm.readDisk(pageID, pool[frameIdx].data); // Pull the page from disk into RAM
-        pool[frameIdx].pageID = pageID; // Update metadata for this frame
-        pool[frameIdx].dirty = false;   // Reset dirty flag as it matches disk content
-        pageTable[pageID] = frameIdx;   // Update Page Table with new location
-        touch(frameIdx);                // Update LRU list
-        return pool[frameIdx].data;     // Return data pointer
-    }
-
-    int allocatePage() {
-        int pid = nextPageID++;         // Generate a new unique Page ID
-        cout << "[SYSTEM] Allocating new Page " << pid << endl;
-        char* p = fetchPage(pid);       // Bring the new page into the buffer
-        memset(p, 0, PAGE_SIZE);        // Initialize the new page with zeros
-        markDirty(pid);                 // Ensure it gets saved to disk later
-        return pid;                     // Return the ID for the B+ tree to use
-    }
-
-    // Set dirty flag to true when the B+ Tree modifies a page
-    void markDirty(int pageID) { if(pageTable.count(pageID)) pool[pageTable[pageID]].dirty = true; }
-
-    int evict() {
-        if (lru.size() < BUFFER_CAPACITY) return lru.size(); // Use next empty slot if available
-        int idx = lru.back();           // Pick the least recently used frame as the "victim"
-        cout << "[EVICT] Buffer full. Kicking out Page " << pool[idx].pageID << " (LRU Policy)." << endl;
-        if (pool[idx].dirty) sm.writeDisk(pool[idx].pageID, pool[idx].data); // Save if modified
-        pageTable.erase(pool[idx].pageID); // Remove the evicted page from the lookup map
-        lru.pop_back();                 // Remove from the tracking list
-        return idx;                     // Return the index for re-use
-    }
-
-    void touch(int idx) {
-        lru.remove(idx);                // Find the frame index in the list
-        lru.push_front(idx);            // Move it to the front (Most Recently Used)
-    }
-};
-
-// --- B+ TREE NODE STRUCTURE ---
-// Binary layout of a B+ tree node inside a 4KB page
-struct BPlusNode {
-    bool isLeaf;                   // Flag: True for leaf nodes, False for internal nodes
-    int numKeys;                   // Current number of keys stored in this node
-    int parentPage;                // PageID of the parent node (for upward traversal)
-    int keys[MAX_KEYS];            // Sorted array of integer keys
-    int children[MAX_KEYS + 1];    // Pointers (PageIDs) to child nodes or data
-    int nextLeaf;                  // Linked list pointer to the next leaf sibling
-};
-
-class BPlusTree {
-    BufferManager& bm;             // Access to the memory management layer
-    int rootPage;                  // The PageID of the top-most node (Root)
-
-public:
-    BPlusTree(BufferManager& b) : bm(b) {
-        rootPage = bm.allocatePage();  // Initialize the tree with a root page
-        BPlusNode* root = (BPlusNode*)bm.fetchPage(rootPage); // Cast bytes to Node struct
-        root->isLeaf = true;           // Every new tree starts with the root as a leaf
-        root->numKeys = 0;             // Root starts empty
-        root->parentPage = -1;         // Root has no parent
-    }
-
-    void insert(int key) {
-        cout << "\n>>> USER COMMAND: INSERT " << key << " <<<" << endl;
-        int leafPage = findLeaf(rootPage, key); // Find the leaf where the key belongs
-        insertIntoLeaf(leafPage, key);          // Execute the leaf insertion logic
-    }
-
-    int findLeaf(int currPage, int key) {
-        BPlusNode* node = (BPlusNode*)bm.fetchPage(currPage); // Load node from buffer
-        if (node->isLeaf) return currPage;                   // If it's a leaf, return its ID
-        int i = 0;                                           // Navigation logic:
-        while (i < node->numKeys && key >= node->keys[i]) i++; // Find correct child pointer
-        return findLeaf(node->children[i], key);             // Recurse down the tree
-    }
-
-    void insertIntoLeaf(int pageID, int key) {
-        BPlusNode* node = (BPlusNode*)bm.fetchPage(pageID);  // Get leaf from buffer
-        if (node->numKeys < MAX_KEYS) {                      // If room exists:
-            int i = node->numKeys - 1;                       // Shift keys to maintain order
-            while (i >= 0 && node->keys[i] > key) {
-                node->keys[i + 1] = node->keys[i];
-                i--;
-            }
-            node->keys[i + 1] = key;                         // Insert the new key
-            node->numKeys++;                                 // Update key count
-            bm.markDirty(pageID);                            // Mark page for disk write
-            cout << "[TREE] Key " << key << " placed in Leaf Page " << pageID << endl;
-        } else {
-            splitLeaf(pageID, key);                          // Node full: trigger split
-        }
-    }
-
-    void splitLeaf(int oldPageID, int key) {
-        cout << "[TREE] Node full! Initiating B+ Tree Split Logic..." << endl;
-        int newPageID = bm.allocatePage();   // Allocate new sibling page
-        BPlusNode* oldNode = (BPlusNode*)bm.fetchPage(oldPageID); // Get old node
-        BPlusNode* newNode = (BPlusNode*)bm.fetchPage(newPageID); // Get new sibling
-
-        vector<int> tempKeys(oldNode->keys, oldNode->keys + MAX_KEYS); // Copy existing keys
-        tempKeys.push_back(key);             // Add the new key to the set
-        sort(tempKeys.begin(), tempKeys.end()); // Sort the overflowed set
-
-        newNode->isLeaf = true;              // Sibling is a leaf
-        int mid = (MAX_KEYS + 1) / 2;        // Determine split point (half-full)
-        oldNode->numKeys = mid;              // Assign first half to old node
-        newNode->numKeys = (MAX_KEYS + 1) - mid; // Assign second half to new node
-
-        for (int i = 0; i < oldNode->numKeys; i++) oldNode->keys[i] = tempKeys[i]; // Copy first half
-        for (int i = 0; i < newNode->numKeys; i++) newNode->keys[i] = tempKeys[mid + i]; // Copy second half
-
-        bm.markDirty(oldPageID);             // Save changes to old node
-        bm.markDirty(newPageID);             // Save changes to new sibling
-        cout << "[TREE] Split complete. New Leaf Page " << newPageID << " created." << endl;
-        
-        insertIntoParent(oldPageID, newNode->keys[0], newPageID); // Push middle key to parent
-    }
-
-    void insertIntoParent(int left, int key, int right) {
-        if (left == rootPage) {              // If root was split, create new root
-            int newRoot = bm.allocatePage(); // Get page for new top node
-            BPlusNode* r = (BPlusNode*)bm.fetchPage(newRoot); // Get struct pointer
-            r->isLeaf = false;               // New root is an Internal Node
-            r->keys[0] = key;                // Store the promoted key
-            r->children[0] = left;           // Left pointer points to old root
-            r->children[1] = right;          // Right pointer points to new sibling
-            r->numKeys = 1;                  // New root starts with 1 key
-            rootPage = newRoot;              // Update tree root ID
-            cout << "[TREE] New Root created (Page " << newRoot << "). Tree height increased!" << endl;
-        }
-    }
-};
-
-#endif
\ No newline at end of file
+#ifndef STORAGE_ENGINE_HPP
+#define STORAGE_ENGINE_HPP
+
+#include "Trace.hpp"    // Compile-time gated tracing that replaces per-operation cout logging
+#include "KeySearch.hpp" // Branchless and SIMD lower-bound kernels for searching inside a node
+#include "ReplacementPolicy.hpp" // Frame layout and the pluggable LRU/CLOCK/CLOCK-Pro eviction policies
+#include <vector>       // Used to manage the collection of frames in the Buffer Pool
+#include <unordered_map> // Used for the Page Table to achieve O(1) page lookups in RAM
+#include <list>         // Recency order of the protected tier of root/internal pages
+#include <thread>       // Background writer that cleans frames ahead of eviction
+#include <mutex>        // Frame metadata latch shared with the background writer
+#include <condition_variable> // Writer wake-ups and waits for its batches to finish
+#include <chrono>       // Background writer delay between rounds
+#include <cstring>      // Provides memory manipulation functions like memset and memcpy
+#include <algorithm>    // sort for checkpoint write order, find/min/max helpers
+#include <string>       // File names and error messages
+#include <cstdint>      // Fixed-width fields in the on-disk database header
+#include <climits>      // INT_MIN: cached maximum of an empty rightmost leaf
+#include <stdexcept>    // Provides invalid_argument/runtime_error for configuration and I/O failures
+#include <cerrno>       // errno from failed system calls
+#include <fcntl.h>      // POSIX open() for the database file descriptor
+#include <unistd.h>     // POSIX pread/pwrite/fdatasync/close for positional page I/O
+
+using namespace std;    // Allows using standard library members without the std:: prefix
+
+// --- GLOBAL SYSTEM DEFAULTS ---
+const int DEFAULT_PAGE_SIZE = 4096;    // 4KB: The standard block size for disk/RAM data transfer
+const int DEFAULT_BUFFER_CAPACITY = 3; // Limits RAM to 3 pages to force eviction logic visibility
+const int DEFAULT_MAX_KEYS = 0;        // Max keys per node; 0 fills each page with keys
+
+// --- ENGINE CONFIGURATION ---
+// Runtime settings chosen when the engine starts; shared by every layer
+struct EngineConfig {
+    int pageSize = DEFAULT_PAGE_SIZE;           // Bytes per page: a power of two from 4KB to 64KB
+    size_t bufferFrames = DEFAULT_BUFFER_CAPACITY; // Number of page frames in the Buffer Pool
+    size_t bufferBytes = 0;                     // RAM budget for the Buffer Pool; 0 uses bufferFrames
+    int maxKeys = DEFAULT_MAX_KEYS;             // Keys per node; 0 derives the fanout from pageSize,
+                                                // small values (e.g. 3) make splits easy to observe
+    bool truncate = false;                      // Wipe an existing database file instead of opening it
+    bool compressKeys = true;                   // VarKeyTree: prefix-compress nodes, truncate separators
+    Replacement replacement = Replacement::LRU; // Buffer Pool eviction policy
+    double protectedShare = 0.25;               // Share of the pool that keeps root/internal pages
+                                                // out of the policy's reach; 0 ignores the hints
+    bool backgroundWriter = false;              // Write dirty frames near the eviction end from a
+                                                // separate thread, so evictions find clean victims
+    int writerDelayMs = 10;                     // Background writer: pause between rounds
+    int writerMaxPages = 64;                    // Background writer: most pages written per round
+    double writerLookahead = 0.25;              // Background writer: share of the pool, from the
+                                                // eviction end, it tries to keep clean
+
+    // Size the Buffer Pool by RAM budget instead of frame count. The budget is divided by the
+    // page size in use, which for an existing file is the one in its header, not pageSize.
+    void setBufferBytes(size_t bytes) { bufferBytes = bytes; }
+    size_t framesFor(int filePageSize) const { return bufferBytes ? bufferBytes / filePageSize : bufferFrames; }
+
+    void validate() const {
+        if (pageSize < 4096 || pageSize > 65536 || (pageSize & (pageSize - 1)) != 0)
+            throw invalid_argument("pageSize must be a power of two between 4096 and 65536");
+        if (bufferFrames < 1)
+            throw invalid_argument("bufferFrames must be at least 1");
+        if (maxKeys < 0)
+            throw invalid_argument("maxKeys must be positive, or 0 to derive it from pageSize");
+        if (protectedShare < 0 || protectedShare >= 1)
+            throw invalid_argument("protectedShare must be in [0, 1)");
+        if (writerDelayMs < 1 || writerMaxPages < 1 || writerLookahead <= 0 || writerLookahead > 1)
+            throw invalid_argument("writerDelayMs and writerMaxPages must be at least 1, writerLookahead in (0, 1]");
+    }
+};
+
+// --- DATABASE HEADER (PAGE 0) ---
+// Persistent metadata at the start of the file; everything needed to reopen the database
+const uint32_t DB_MAGIC = 0x53424D44;   // "DMBS" in little-endian byte order
+const uint32_t DB_FORMAT_VERSION = 4;   // Bumped whenever the on-disk layout changes
+
+struct DbHeader {
+    uint32_t magic;                // Identifies the file as a Mini-DBMS database
+    uint32_t version;              // On-disk format version
+    int32_t pageSize;              // Page size the file was created with
+    int32_t maxKeys;               // B+ tree fanout the file was created with; 0 until a tree exists
+    int32_t rootPage;              // PageID of the B+ tree root; -1 until a tree exists
+    int32_t nextPageID;            // Next unused PageID (page 0 is the header itself)
+    int32_t freeListHead;          // First page of the free list; -1 when no page is free
+    int32_t freePages;             // Number of pages on the free list
+    int32_t keyFormat;             // Node layout of the tree in this file (KEY_FORMAT_*)
+};
+
+const int32_t KEY_FORMAT_INT = 0;      // BPlusTree: fixed int keys and child arrays
+const int32_t KEY_FORMAT_BYTES = 1;    // VarKeyTree: slotted pages of variable-length byte keys
+
+// Layout of a page on the free list: each one links to the next, the header holds the head
+struct FreePage {
+    int32_t nextFree;              // Next free PageID; -1 at the end of the list
+};
+
+// --- STORAGE MANAGER (DISK LAYER) ---
+// Manages the physical byte-offsets within the binary database file.
+// All I/O is positional (pread/pwrite) on one descriptor: there is no shared file
+// cursor, so several threads may read and write different pages at the same time.
+class StorageManager {
+    string fileName;               // The string name of the database file on disk
+    int fd = -1;                   // POSIX descriptor for the database file
+    int pageSize;                  // Bytes per page, fixed for the lifetime of the file
+    DbHeader hdr;                  // In-memory copy of page 0, written back by writeHeader()
+
+    [[noreturn]] void fail(const string& what) const { // Report a failed system call
+        throw runtime_error(what + " failed on " + fileName + ": " + strerror(errno));
+    }
+
+public:
+    StorageManager(string name, const EngineConfig& config = EngineConfig())
+        : fileName(name), pageSize(config.pageSize) {
+        config.validate();         // Reject unsupported page sizes before touching the disk
+        // Open file: read/write, create if missing, and trunc only when asked (e.g. a clean demo)
+        int flags = O_RDWR | O_CREAT | (config.truncate ? O_TRUNC : 0);
+        fd = ::open(fileName.c_str(), flags, 0644);
+        if (fd == -1) throw runtime_error("cannot open " + fileName + ": " + strerror(errno));
+
+        off_t size = lseek(fd, 0, SEEK_END);       // Empty file: a brand-new database
+        if (size == 0) {
+            hdr.magic = DB_MAGIC;
+            hdr.version = DB_FORMAT_VERSION;
+            hdr.pageSize = pageSize;
+            hdr.maxKeys = 0;                       // Chosen by the first tree built on the file
+            hdr.rootPage = -1;
+            hdr.nextPageID = 1;                    // Page 0 is reserved for this header
+            hdr.freeListHead = -1;                 // Nothing has been freed yet
+            hdr.freePages = 0;
+            hdr.keyFormat = KEY_FORMAT_INT;        // Overwritten by the first tree built on the file
+            try {
+                writeHeader();
+            } catch (...) {                        // No destructor runs for a failed constructor
+                ::close(fd);
+                throw;
+            }
+            TRACE(TRACE_LEVEL_INFO, "[DISK] Created new database %s", fileName.c_str());
+        } else {
+            bool complete = pread(fd, &hdr, sizeof(hdr), 0) == (ssize_t)sizeof(hdr);
+            if (!complete || hdr.magic != DB_MAGIC || hdr.version != DB_FORMAT_VERSION) {
+                ::close(fd);
+                throw runtime_error(fileName + " is not a Mini-DBMS database of format version " +
+                                    to_string(DB_FORMAT_VERSION));
+            }
+            pageSize = hdr.pageSize;               // The file's page size wins over the config
+            TRACE(TRACE_LEVEL_INFO, "[DISK] Opened %s: %d pages, root Page %d", fileName.c_str(),
+                  hdr.nextPageID, hdr.rootPage);
+        }
+    }
+    ~StorageManager() { if (fd != -1) ::close(fd); }
+    StorageManager(const StorageManager&) = delete;            // Owns the descriptor
+    StorageManager& operator=(const StorageManager&) = delete;
+
+    int getPageSize() const { return pageSize; }
+    DbHeader& header() { return hdr; } // Mutated by upper layers, persisted by writeHeader()
+
+    void writeHeader() {           // Page 0: header fields followed by zero padding
+        vector<char> page(pageSize, 0);
+        memcpy(page.data(), &hdr, sizeof(hdr));
+        writeDisk(0, page.data());
+    }
+
+    // Durability point: wait until every page written so far is on stable storage
+    void sync() {
+        TRACE(TRACE_LEVEL_INFO, "[DISK] Syncing %s to stable storage...", fileName.c_str());
+        if (fdatasync(fd) == -1) fail("fdatasync");
+    }
+
+    void writeDisk(int pageID, const char* data) {
+        TRACE(TRACE_LEVEL_DEBUG, "[DISK] Writing Page %d to %s...", pageID, fileName.c_str());
+        writeRun(pageID, data, 1);
+    }
+
+    // Sequential write of 'count' adjacent pages starting at 'firstPageID' with one pwrite
+    void writePages(int firstPageID, const char* data, int count) {
+        TRACE(TRACE_LEVEL_DEBUG, "[DISK] Writing Pages %d-%d to %s...", firstPageID,
+              firstPageID + count - 1, fileName.c_str());
+        writeRun(firstPageID, data, count);
+    }
+
+    void writeRun(int pageID, const char* data, int count) { // Shared by writeDisk and writePages
+        off_t offset = (off_t)pageID * pageSize; // Byte position of the first page in the file
+        size_t bytes = (size_t)count * pageSize;
+        size_t done = 0;
+        while (done < bytes) {                     // pwrite may write less than asked
+            ssize_t n = pwrite(fd, data + done, bytes - done, offset + done);
+            if (n == -1) {
+                if (errno == EINTR) continue;      // Interrupted by a signal: retry
+                fail("pwrite of page " + to_string(pageID));
+            }
+            done += n;
+        }
+    }
+
+    void readDisk(int pageID, char* buffer) {
+        TRACE(TRACE_LEVEL_DEBUG, "[DISK] Reading Page %d from disk...", pageID);
+        off_t offset = (off_t)pageID * pageSize; // Byte position of the page in the file
+        size_t done = 0;
+        while (done < (size_t)pageSize) {
+            ssize_t n = pread(fd, buffer + done, pageSize - done, offset + done);
+            if (n == -1) {
+                if (errno == EINTR) continue;      // Interrupted by a signal: retry
+                fail("pread of page " + to_string(pageID));
+            }
+            if (n == 0) break;                     // Pages allocated but never written lie past EOF
+            done += n;
+        }
+        memset(buffer + done, 0, pageSize - done); // Missing bytes read back as zeros
+    }
+};
+
+// --- BUFFER MANAGER (RAM LAYER) ---
+// Counters since the Buffer Manager started
+struct BufferStats {
+    long hits = 0;                 // fetchPage() calls served from RAM
+    long misses = 0;               // fetchPage() calls that read the page from disk
+    long evictions = 0;            // Frames reclaimed from another page
+    long dirtyWrites = 0;          // Evicted pages the foreground had to write back first
+    long backgroundWrites = 0;     // Dirty pages the background writer cleaned ahead of eviction
+    int adaptiveTarget = -1;       // Policy's self-tuned split: ARC's T1 target p, CLOCK-Pro's
+                                   // cold target; -1 for policies without one
+    int protectedFrames = 0;       // Frames currently in the protected tier
+    bool writerFailed = false;     // The background writer stopped on a write error
+};
+
+class BufferManager;
+
+// --- PAGE GUARD ---
+// RAII pin on a buffered page: while a guard is alive its frame cannot be evicted,
+// so the data pointer stays valid across other fetches. Move-only; unpins on destruction.
+class PageGuard {
+    BufferManager* bm = nullptr;   // Owning buffer manager; null for an empty guard
+    int pageID = -1;               // Pinned page
+    char* data = nullptr;          // Frame memory of the pinned page
+
+public:
+    PageGuard() {}
+    PageGuard(BufferManager* b, int pid, char* d) : bm(b), pageID(pid), data(d) {}
+    PageGuard(PageGuard&& other) noexcept { *this = std::move(other); }
+    PageGuard& operator=(PageGuard&& other) noexcept {
+        if (this != &other) {
+            release();             // Drop whatever this guard held before
+            bm = other.bm; pageID = other.pageID; data = other.data;
+            other.bm = nullptr; other.pageID = -1; other.data = nullptr;
+        }
+        return *this;
+    }
+    PageGuard(const PageGuard&) = delete;
+    PageGuard& operator=(const PageGuard&) = delete;
+    ~PageGuard() { release(); }
+
+    int id() const { return pageID; }
+    char* get() const { return data; }
+    template <typename T> T* as() const { return (T*)data; } // View the page as a struct
+    void markDirty();              // Page was modified: write it back before eviction
+    void setPriority(PagePriority p); // Tree-level hint, see BufferManager::setPriority()
+    void release();                // Unpin early; the guard becomes empty
+};
+
+class BufferManager {
+    StorageManager& sm;            // Reference to the Storage Layer for Disk I/O
+    int pageSize;                  // Bytes per frame, taken from the Storage Layer
+    vector<char> arena;            // One contiguous allocation backing every frame's data
+    vector<Frame> pool;            // The Buffer Pool: a vector of RAM frames
+    unordered_map<int, int> pageTable; // Fast mapping: PageID -> index in 'pool' vector
+    unique_ptr<ReplacementPolicy> policy; // Chooses the victim frame when the pool is full
+    size_t filled = 0;             // Frames that have held a page; the rest are still empty
+    vector<int> emptied;           // Frames left empty by a failed read, reused before evicting
+    BufferStats counters;          // Hit/miss/eviction counts reported by stats()
+    // Protected tier: frames hinted ROOT or INTERNAL, in LRU order outside the policy
+    list<int> protectedLru;        // Front is Newest, Back is Oldest
+    vector<list<int>::iterator> protectedPos; // Each protected frame's node in 'protectedLru'
+    size_t protectedLimit;         // Most frames the tier may hold (protectedShare of the pool)
+    // Background writer (EngineConfig::backgroundWriter)
+    thread writer;                 // Runs writerLoop(); not started when the writer is off
+    mutable mutex latch;           // Guards frames, page table, policy and counters while it runs
+    condition_variable writerWake; // Cuts the writer's pause short at shutdown
+    condition_variable_any writesDone; // Signalled when a background batch is on disk
+    bool stopping = false;         // Set by the destructor to end writerLoop()
+    int inFlight = 0;              // Frames the writer has pinned for the batch in progress
+    chrono::milliseconds writerDelay;
+    int writerMaxPages;
+    size_t writerLookahead;        // Frames examined from the eviction end each round
+    vector<char> writerStaging;    // Copies of the batch being written, writerMaxPages pages
+    string writerError;            // Why the writer stopped; thrown by the next checkpoint()
+
+    // Frame metadata latch. It is only taken while the background writer shares the pool,
+    // so a single-threaded engine pays nothing for it.
+    unique_lock<mutex> lock() const { return writer.joinable() ? unique_lock<mutex>(latch) : unique_lock<mutex>(); }
+
+    // Each round writes up to writerMaxPages dirty, unpinned frames among the first
+    // writerLookahead frames the policy would evict. Under the latch the writer copies its
+    // batch, clears the dirty flags and pins the frames; it then writes the copies in PageID
+    // order without the latch. The pins keep the frames from being evicted and reloaded
+    // from disk mid-write, and a change made meanwhile dirties the frame again, so the next
+    // write carries it. A failed write leaves the frames dirty and stops the writer; the
+    // error is kept for the next checkpoint(), and eviction writes those frames meanwhile.
+    void writerLoop() {
+        unique_lock<mutex> held(latch);
+        vector<int> candidates, batch;
+        while (!stopping) {
+            writerWake.wait_for(held, writerDelay, [this] { return stopping; });
+            if (stopping) break;
+            candidates.clear();
+            batch.clear();
+            policy->evictionCandidates(candidates, writerLookahead);
+            for (int idx : candidates) {
+                if (!pool[idx].dirty || pool[idx].pinCount > 0) continue; // Clean, or in use by the foreground
+                batch.push_back(idx);
+                if ((int)batch.size() == writerMaxPages) break;
+            }
+            if (batch.empty()) continue;
+            sort(batch.begin(), batch.end(), [this](int a, int b) { return pool[a].pageID < pool[b].pageID; });
+            for (size_t i = 0; i < batch.size(); i++) {
+                Frame& f = pool[batch[i]];
+                memcpy(&writerStaging[i * pageSize], f.data, pageSize); // Unpinned: nobody is changing it
+                f.dirty = false;
+                f.pinCount++;
+            }
+            inFlight = (int)batch.size();
+            held.unlock();
+            size_t written = 0;
+            string error;
+            try {
+                for (int idx : batch) { // Pinned: pageID stays put without the latch
+                    sm.writeDisk(pool[idx].pageID, &writerStaging[written * pageSize]);
+                    written++;
+                }
+            } catch (const runtime_error& e) {
+                error = e.what();
+            }
+            held.lock();
+            for (size_t i = 0; i < batch.size(); i++) {
+                pool[batch[i]].pinCount--;
+                if (i >= written) pool[batch[i]].dirty = true;
+            }
+            counters.backgroundWrites += written;
+            inFlight = 0;
+            writesDone.notify_all();
+            TRACE(TRACE_LEVEL_DEBUG, "[WRITER] Wrote %d dirty pages ahead of eviction.", (int)written);
+            if (written < batch.size()) {
+                writerError = error;
+                counters.writerFailed = true;
+                TRACE(TRACE_LEVEL_INFO, "[WRITER] Stopped: %s", error.c_str());
+                break;
+            }
+        }
+    }
+
+public:
+    BufferManager(StorageManager& s, const EngineConfig& config = EngineConfig())
+        : sm(s), pageSize(s.getPageSize()) {
+        config.validate();
+        size_t frames = config.framesFor(pageSize); // Page size read from the file header
+        if (frames < 1)
+            throw invalid_argument("bufferBytes must hold at least one " + to_string(pageSize) + "-byte page");
+        arena.resize(frames * pageSize); // Reserve all frame memory up front
+        pool.resize(frames);
+        for (size_t i = 0; i < pool.size(); i++) pool[i].data = &arena[i * pageSize];
+        policy = makePolicy(config.replacement, pool);
+        protectedPos.resize(pool.size());
+        protectedLimit = (size_t)(config.protectedShare * pool.size());
+        writerDelay = chrono::milliseconds(config.writerDelayMs);
+        writerMaxPages = config.writerMaxPages;
+        writerLookahead = max((size_t)1, (size_t)(config.writerLookahead * pool.size()));
+        if (config.backgroundWriter) {
+            writerStaging.resize((size_t)writerMaxPages * pageSize);
+            writer = thread(&BufferManager::writerLoop, this);
+        }
+    }
+
+    ~BufferManager() {
+        if (!writer.joinable()) return;
+        {
+            lock_guard<mutex> held(latch);
+            stopping = true;
+        }
+        writerWake.notify_all();
+        writer.join();
+    }
+
+    int getPageSize() const { return pageSize; }
+    int getNextPageID() { return sm.header().nextPageID; } // File size in pages, header included
+    int getFreePageCount() { return sm.header().freePages; } // Pages waiting on the free list
+    DbHeader& header() { return sm.header(); } // File metadata shared with the B+ tree
+    BufferStats stats() const {
+        auto held = lock();
+        BufferStats s = counters;
+        s.adaptiveTarget = policy->adaptiveTarget(); // Sampled now: it moves with the workload
+        s.protectedFrames = (int)protectedLru.size();
+        return s;
+    }
+    const char* policyName() const { return policy->name(); }
+
+    // Raw access: the pointer is only valid until the next fetch may evict the frame.
+    // Code that holds a page across other buffer calls must use pinPage() instead.
+    char* fetchPage(int pageID) {
+        auto held = lock();
+        return pool[fetchFrame(pageID)].data;
+    }
+
+    int fetchFrame(int pageID) {        // Frame holding 'pageID', loading it on a miss; latch held
+        auto hit = pageTable.find(pageID); // Single hash probe for the lookup
+        if (hit != pageTable.end()) {  // CASE: Page is already in RAM (Buffer Hit)
+            TRACE(TRACE_LEVEL_DEBUG, "[BUFFER] Hit! Page %d found in RAM.", pageID);
+            counters.hits++;
+            if (pool[hit->second].priority == PagePriority::NORMAL)
+                policy->onHit(hit->second); // Let the policy record the reference
+            else                        // Protected tier keeps its own recency order
+                protectedLru.splice(protectedLru.begin(), protectedLru, protectedPos[hit->second]);
+            return hit->second;
+        }
+        // CASE: Page is not in RAM (Buffer Miss)
+        TRACE(TRACE_LEVEL_DEBUG, "[BUFFER] Miss! Page %d not in RAM.", pageID);
+        counters.misses++;
+        int frameIdx = evict(pageID);  // Find or create a free frame in RAM
+        try {
+            sm.readDisk(pageID, pool[frameIdx].data); // Pull the page from disk into RAM
+        } catch (...) {                 // Neither the page table nor the policy holds the frame now
+            pool[frameIdx].pageID = -1;
+            pool[frameIdx].dirty = false;
+            emptied.push_back(frameIdx);
+            throw;
+        }
+        pool[frameIdx].pageID = pageID; // Update metadata for this frame
+        pool[frameIdx].dirty = false;   // Reset dirty flag as it matches disk content
+        pageTable[pageID] = frameIdx;   // Update Page Table with new location
+        policy->onLoad(frameIdx);       // Start tracking the new page
+        return frameIdx;
+    }
+
+    PageGuard pinPage(int pageID) {
+        auto held = lock();
+        int idx = fetchFrame(pageID);   // Bring the page in (may evict an unpinned frame)
+        pool[idx].pinCount++;
+        return PageGuard(this, pageID, pool[idx].data);
+    }
+
+    void unpinPage(int pageID) {
+        auto held = lock();
+        auto it = pageTable.find(pageID);
+        if (it != pageTable.end() && pool[it->second].pinCount > 0) pool[it->second].pinCount--;
+    }
+
+    int allocatePage() {
+        auto held = lock();
+        DbHeader& hdr = sm.header();
+        int pid, idx;
+        if (hdr.freeListHead != -1) {   // Reuse a freed page before growing the file
+            pid = hdr.freeListHead;
+            idx = fetchFrame(pid);
+            hdr.freeListHead = ((FreePage*)pool[idx].data)->nextFree; // Unlink it from the free list
+            hdr.freePages--;
+            TRACE(TRACE_LEVEL_INFO, "[SYSTEM] Reusing free Page %d", pid);
+        } else {
+            pid = hdr.nextPageID++;     // Generate a new unique Page ID (persisted in page 0)
+            TRACE(TRACE_LEVEL_INFO, "[SYSTEM] Allocating new Page %d", pid);
+            idx = fetchFrame(pid);      // Bring the new page into the buffer
+        }
+        memset(pool[idx].data, 0, pageSize); // Initialize the new page with zeros
+        prioritize(idx, PagePriority::NORMAL); // A reused page may have been an internal node
+        pool[idx].dirty = true;         // Ensure it gets saved to disk later
+        return pid;                     // Return the ID for the B+ tree to use
+    }
+
+    // Returns a page that is no longer referenced to the free list; allocatePage() hands it out again
+    void freePage(int pageID) {
+        auto held = lock();
+        DbHeader& hdr = sm.header();
+        int idx = fetchFrame(pageID);
+        char* p = pool[idx].data;
+        memset(p, 0, pageSize);
+        prioritize(idx, PagePriority::NORMAL);
+        ((FreePage*)p)->nextFree = hdr.freeListHead; // Push onto the front of the list
+        pool[idx].dirty = true;
+        hdr.freeListHead = pageID;
+        hdr.freePages++;
+        TRACE(TRACE_LEVEL_INFO, "[SYSTEM] Page %d added to the free list", pageID);
+    }
+
+    // Bulk path: writes 'count' fully built pages straight to the end of the file with one
+    // sequential write, bypassing the pool. Returns the PageID of the first one.
+    int appendPages(const char* data, int count) {
+        DbHeader& hdr = sm.header();
+        int first = hdr.nextPageID;
+        sm.writePages(first, data, count); // Fresh PageIDs: no frame can hold a stale copy
+        hdr.nextPageID += count;
+        return first;
+    }
+
+    // Commit boundary: write back every dirty frame, then make the file durable with one sync.
+    // Throws, before writing anything, if the background writer stopped on an error since
+    // the last call; stats().writerFailed stays set.
+    void checkpoint() {
+        auto held = lock();
+        while (inFlight > 0) writesDone.wait(latch); // Background writes must land before the sync
+        if (!writerError.empty()) {     // Reported once: a retry checkpoints without the writer
+            string error = writerError;
+            writerError.clear();
+            throw runtime_error("background writer stopped: " + error);
+        }
+        vector<int> dirtyFrames;        // Collect first so pages can be written in file order
+        for (size_t i = 0; i < pool.size(); i++)
+            if (pool[i].pageID != -1 && pool[i].dirty) dirtyFrames.push_back(i);
+        sort(dirtyFrames.begin(), dirtyFrames.end(),
+             [this](int a, int b) { return pool[a].pageID < pool[b].pageID; });
+        for (int idx : dirtyFrames) {
+            sm.writeDisk(pool[idx].pageID, pool[idx].data); // Frame stays cached, just clean now
+            pool[idx].dirty = false;
+        }
+        TRACE(TRACE_LEVEL_INFO, "[SYSTEM] Checkpoint wrote %d dirty pages.", (int)dirtyFrames.size());
+        sm.sync();                      // One durability barrier for the whole batch...
+        sm.writeHeader();               // ...then publish the root/page count that refers to it
+        sm.sync();
+    }
+
+    // Set dirty flag to true when the B+ Tree modifies a page
+    void markDirty(int pageID) {
+        auto held = lock();
+        auto it = pageTable.find(pageID);
+        if (it != pageTable.end()) pool[it->second].dirty = true;
+    }
+
+    // Tree-level hint for a pinned page. ROOT and INTERNAL pages move to the protected tier,
+    // where the replacement policy cannot pick them; leaves are evicted first, so the upper
+    // levels of a large index stay resident even with a modest pool. The tier is bounded by
+    // protectedShare: when it is full, its least recently used internal page goes back to
+    // the policy (still resident) to make room.
+    void setPriority(const PageGuard& page, PagePriority p) {
+        if (protectedLimit == 0 || !page.get()) return;
+        auto held = lock();
+        prioritize(frameOf(page.get()), p);
+    }
+
+    int frameOf(const char* data) const { return (int)((data - arena.data()) / pageSize); } // Frames slice the arena
+
+    void prioritize(int idx, PagePriority p) {
+        Frame& f = pool[idx];
+        if (f.priority == p) return;    // Common case: the hint is already in place
+        if (p == PagePriority::NORMAL) {
+            unprotect(idx);
+            policy->onLoad(idx);        // Back under the policy, as a newly loaded page
+            return;
+        }
+        if (f.priority == PagePriority::NORMAL) { // Entering the tier
+            if (protectedLru.size() >= protectedLimit && !demoteOldest()) return; // Tier is all roots
+            policy->onRemove(idx);
+            protectedLru.push_front(idx);
+            protectedPos[idx] = protectedLru.begin();
+        }
+        f.priority = p;
+    }
+
+    void unprotect(int idx) {
+        protectedLru.erase(protectedPos[idx]);
+        pool[idx].priority = PagePriority::NORMAL;
+    }
+
+    bool demoteOldest() {               // Hands the tier's LRU internal page back to the policy
+        for (auto it = protectedLru.rbegin(); it != protectedLru.rend(); ++it) {
+            if (pool[*it].priority == PagePriority::ROOT) continue;
+            prioritize(*it, PagePriority::NORMAL);
+            return true;
+        }
+        return false;
+    }
+
+    int evictProtected() {              // Last resort when every frame the policy tracks is pinned
+        int root = -1;
+        for (auto it = protectedLru.rbegin(); it != protectedLru.rend(); ++it) {
+            if (pool[*it].pinCount > 0) continue;
+            if (pool[*it].priority == PagePriority::ROOT) { root = *it; continue; } // Roots go last
+            int idx = *it;
+            unprotect(idx);
+            return idx;
+        }
+        if (root != -1) unprotect(root);
+        return root;
+    }
+
+    int evict(int pageID) {             // Frees a frame to hold 'pageID'; latch held
+        if (filled < pool.size()) return filled++; // Use next empty slot if available
+        if (!emptied.empty()) {
+            int idx = emptied.back();
+            emptied.pop_back();
+            return idx;
+        }
+        int idx = policy->victim(pageID); // Policy picks an unpinned frame...
+        if (idx == -1) idx = evictProtected(); // ...or, if all of its frames are pinned, the tier does
+        while (idx == -1 && inFlight > 0) { // Frames pinned by the background writer free up soon
+            writesDone.wait(latch);
+            idx = policy->victim(pageID);
+            if (idx == -1) idx = evictProtected();
+        }
+        if (idx == -1)                  // ...every frame is pinned: nothing can be evicted
+            throw runtime_error("buffer pool exhausted: all " + to_string(pool.size()) +
+                                " frames are pinned");
+        TRACE(TRACE_LEVEL_INFO, "[EVICT] Buffer full. Kicking out Page %d (%s Policy).", pool[idx].pageID, policy->name());
+        if (pool[idx].dirty) {          // Save if modified
+            try {
+                sm.writeDisk(pool[idx].pageID, pool[idx].data);
+            } catch (...) {             // Page stays resident and dirty: hand the frame back to the policy
+                policy->onLoad(idx);
+                throw;
+            }
+            counters.dirtyWrites++;
+        }
+        counters.evictions++;
+        pageTable.erase(pool[idx].pageID); // Remove the evicted page from the lookup map
+        return idx;                     // Return the index for re-use
+    }
+};
+
+inline void PageGuard::markDirty() { if (bm) bm->markDirty(pageID); }
+inline void PageGuard::setPriority(PagePriority p) { if (bm) bm->setPriority(*this, p); }
+inline void PageGuard::release() {
+    if (bm) bm->unpinPage(pageID);
+    bm = nullptr; pageID = -1; data = nullptr;
+}
+
+// --- B+ TREE NODE STRUCTURE ---
+// Fixed header of a B+ tree node; the key and child arrays follow it inside the page
+// and are sized by the tree's fanout (maxKeys), so they are reached through accessors
+struct BPlusNode {
+    bool isLeaf;                   // Flag: True for leaf nodes, False for internal nodes
+    int numKeys;                   // Current number of keys stored in this node
+    int nextLeaf;                  // Linked list pointer to the next leaf sibling
+
+    int* keys() { return (int*)(this + 1); }                     // Sorted array of integer keys
+    int* children(int maxKeys) { return keys() + maxKeys; }      // Child PageIDs (maxKeys + 1)
+    int* values(int maxKeys) { return children(maxKeys); }       // Leaves: value paired with keys[i]
+};
+
+// Root-to-leaf descent recorded by findLeaf(): the page visited at each level and the child
+// slot taken there. It lives on the stack, and splits and merges walk it back up instead
+// of storing parent links in every node.
+const int MAX_TREE_HEIGHT = 32;        // Nodes have at least two children, so int PageIDs never need more
+
+struct TreePath {
+    int depth = 0;                     // Levels recorded; the leaf is pages[depth - 1]
+    int pages[MAX_TREE_HEIGHT];        // PageID at each level, root first
+    int slots[MAX_TREE_HEIGHT];        // Child index followed at each internal level
+
+    int leaf() const { return pages[depth - 1]; }
+};
+
+// --- BULK LOAD INPUT ---
+// Pairs for BPlusTree::bulkLoad() in strictly ascending key order. ExternalSorter
+// (include/ExternalSort.hpp) turns unsorted input into such a stream.
+struct KeyValueSource {
+    virtual ~KeyValueSource() {}
+    virtual bool next(int& key, int& value) = 0; // Next pair; false once the input is exhausted
+};
+
+// Pairs already sorted in memory, e.g. two parallel arrays of keys and values
+class ArraySource : public KeyValueSource {
+    const int* keys;
+    const int* values;             // nullptr stores 0 for every key
+    size_t count;
+    size_t pos = 0;
+
+public:
+    ArraySource(const int* k, const int* v, size_t n) : keys(k), values(v), count(n) {}
+
+    bool next(int& key, int& value) override {
+        if (pos == count) return false;
+        key = keys[pos];
+        value = values ? values[pos] : 0;
+        pos++;
+        return true;
+    }
+};
+
+// Staging area for bulk loads: nodes are built in a batch of consecutive pages that is
+// appended to the file with one write when it fills. The newest page survives each flush,
+// so the loader can still move keys between it and the page that follows.
+class PageBatch {
+    BufferManager& bm;             // Appends finished pages to the file
+    int pageSize;                  // Bytes per staged page
+    vector<char> staged;           // BATCH_PAGES pages waiting to be written
+    int count = 0;                 // Pages currently staged
+    int nextID;                    // PageID the next page will have in the file
+
+public:
+    static const int BATCH_PAGES = 64; // 256KB sequential writes with 4KB pages
+
+    PageBatch(BufferManager& b)
+        : bm(b), pageSize(b.getPageSize()), staged((size_t)BATCH_PAGES * pageSize), nextID(b.getNextPageID()) {}
+
+    // Zeroed node for the next PageID; invalidates pointers from earlier calls
+    BPlusNode* add(int& pageID) {
+        if (count == BATCH_PAGES) flush(count - 1);
+        char* p = &staged[(size_t)count++ * pageSize];
+        memset(p, 0, pageSize);
+        pageID = nextID++;
+        return (BPlusNode*)p;
+    }
+
+    BPlusNode* newest(int back = 0) {  // The page added 'back' calls ago; 0 is the latest
+        return back < count ? (BPlusNode*)&staged[(size_t)(count - 1 - back) * pageSize] : nullptr;
+    }
+
+    void flush(int pages) {            // Write the oldest 'pages' pages, keep the rest staged
+        bm.appendPages(staged.data(), pages);
+        memmove(staged.data(), &staged[(size_t)pages * pageSize], (size_t)(count - pages) * pageSize);
+        count -= pages;
+    }
+
+    void finish() { if (count) flush(count); }
+};
+
+class BPlusTree {
+    BufferManager& bm;             // Access to the memory management layer
+    int rootPage;                  // The PageID of the top-most node (Root)
+    int maxKeys;                   // Fanout: max keys per node, fixed when the tree is built
+    TreePath rightmost;            // Last descent that ended in the rightmost leaf...
+    bool rightmostValid = false;   // ...still usable until a split or removal reshapes the tree
+    int rightmostMax;              // A key of that leaf, at or below its largest: any key above it
+                                   // belongs to the leaf, so appends are recognised without a pin
+
+public:
+    // --- RANGE ITERATOR ---
+    // Walks keys in ascending order by following the nextLeaf chain; never re-descends from the root.
+    // The current leaf stays pinned, so exactly one frame is held for the iterator's lifetime.
+    class Iterator {
+        BufferManager* bm;         // Buffer used to pin the next leaf in the chain
+        PageGuard leaf;            // Pin on the current leaf; empty once the range is exhausted
+        int slot;                  // Index of the current key inside the leaf
+        int hi;                    // Inclusive upper bound of the scan
+        int maxKeys;               // Fanout, locates the value array inside the leaf
+
+        void settle() {            // Move to the next valid key, hopping leaves as needed
+            while (leaf.get()) {
+                BPlusNode* node = leaf.as<BPlusNode>();
+                if (slot < node->numKeys) {          // Key available in this leaf:
+                    if (node->keys()[slot] > hi) leaf.release(); // Past the upper bound: stop
+                    return;
+                }
+                int next = node->nextLeaf;           // Leaf exhausted: follow sibling link
+                leaf.release();                      // Unpin before pinning the sibling
+                if (next != -1) leaf = bm->pinPage(next);
+                slot = 0;
+            }
+        }
+
+    public:
+        Iterator(BufferManager& b, PageGuard start, int startSlot, int upper, int fanout)
+            : bm(&b), leaf(std::move(start)), slot(startSlot), hi(upper), maxKeys(fanout) { settle(); }
+
+        bool valid() const { return leaf.get() != nullptr; } // False once past 'hi' or the last leaf
+        int key() const { return leaf.as<BPlusNode>()->keys()[slot]; }
+        int value() const { return leaf.as<BPlusNode>()->values(maxKeys)[slot]; }
+        void next() { slot++; settle(); }            // Advance to the following key
+    };
+
+    // Largest fanout whose key and child arrays still fit in one page
+    static int maxFanout(int pageSize) {
+        return (pageSize - (int)sizeof(BPlusNode) - (int)sizeof(int)) / (2 * (int)sizeof(int));
+    }
+
+    BPlusTree(BufferManager& b, const EngineConfig& config = EngineConfig()) : bm(b) {
+        config.validate();
+        DbHeader& hdr = bm.header();
+        if (hdr.rootPage != -1) {      // Existing database: pick up the persisted tree
+            if (hdr.keyFormat != KEY_FORMAT_INT)
+                throw runtime_error("database holds a tree with a different key format");
+            rootPage = hdr.rootPage;
+            maxKeys = hdr.maxKeys;     // The on-disk node layout fixes the fanout
+            return;
+        }
+        int limit = maxFanout(bm.getPageSize()); // Most keys a page of this size can hold
+        maxKeys = config.maxKeys ? config.maxKeys : limit; // 0 means "fill the page"
+        if (maxKeys < 3 || maxKeys > limit)
+            throw invalid_argument("maxKeys must be between 3 and the page's fanout limit");
+        hdr.maxKeys = maxKeys;
+        hdr.keyFormat = KEY_FORMAT_INT;
+        setRoot(bm.allocatePage());    // Initialize the tree with a root page
+        PageGuard page = bm.pinPage(rootPage);
+        BPlusNode* root = page.as<BPlusNode>(); // Cast bytes to Node struct
+        root->isLeaf = true;           // Every new tree starts with the root as a leaf
+        root->numKeys = 0;             // Root starts empty
+        root->nextLeaf = -1;           // No sibling leaves yet
+        page.markDirty();
+    }
+
+    void setRoot(int pageID) {
+        rootPage = pageID;             // Update tree root ID...
+        bm.header().rootPage = pageID; // ...and the copy persisted in the header page
+    }
+
+    int height() {                             // Levels from root to leaf; 1 for a lone root leaf
+        int levels = 1;
+        PageGuard page = bm.pinPage(rootPage);
+        while (!page.as<BPlusNode>()->isLeaf) { // All leaves sit at the same depth: follow leftmost
+            int child = page.as<BPlusNode>()->children(maxKeys)[0];
+            page.release();
+            page = bm.pinPage(child);
+            levels++;
+        }
+        return levels;
+    }
+
+    bool insert(int key, int value = 0) {      // Adds a new key; an existing key is left untouched
+        TRACE(TRACE_LEVEL_INFO, "\n>>> USER COMMAND: INSERT %d <<<", key);
+        TreePath path;
+        if (!appendPath(key, path)) findLeaf(key, path); // Find the leaf where the key belongs
+        return insertIntoLeaf(path, key, value, false); // Execute the leaf insertion logic
+    }
+
+    bool put(int key, int value) {             // Upsert; returns true if the key was new
+        TRACE(TRACE_LEVEL_INFO, "\n>>> USER COMMAND: PUT %d = %d <<<", key, value);
+        TreePath path;
+        if (!appendPath(key, path)) findLeaf(key, path);
+        return insertIntoLeaf(path, key, value, true); // Overwrites the value of an existing key
+    }
+
+    bool get(int key, int& value) {            // Copies the key's value out; false if absent
+        TRACE(TRACE_LEVEL_INFO, "\n>>> USER COMMAND: GET %d <<<", key);
+        return lookup(key, &value);
+    }
+
+    bool find(int key) {
+        TRACE(TRACE_LEVEL_INFO, "\n>>> USER COMMAND: FIND %d <<<", key);
+        return lookup(key, nullptr);
+    }
+
+    bool lookup(int key, int* value) {
+        int leafPage = findLeaf(key);           // Only one leaf can hold the key
+        PageGuard page = bm.pinPage(leafPage);
+        BPlusNode* node = page.as<BPlusNode>();
+        int i = KeySearch::lowerBound(node->keys(), node->numKeys, key);
+        if (i == node->numKeys || node->keys()[i] != key) return false;
+        if (value) *value = node->values(maxKeys)[i]; // Exact match found
+        return true;
+    }
+
+    Iterator scan(int lo, int hi) {
+        TRACE(TRACE_LEVEL_INFO, "\n>>> USER COMMAND: SCAN [%d, %d] <<<", lo, hi);
+        int leafPage = findLeaf(lo);            // Single descent to the first candidate leaf
+        PageGuard page = bm.pinPage(leafPage);
+        BPlusNode* node = page.as<BPlusNode>();
+        int i = KeySearch::lowerBound(node->keys(), node->numKeys, lo); // Skip keys below the lower bound
+        return Iterator(bm, std::move(page), i, hi, maxKeys); // Iterator hops leaves from here on
+    }
+
+    bool remove(int key) {
+        TRACE(TRACE_LEVEL_INFO, "\n>>> USER COMMAND: REMOVE %d <<<", key);
+        TreePath path;
+        int leafPage = findLeaf(key, path);     // Only one leaf can hold the key
+        rightmostValid = false;                 // Merges and borrows may move the rightmost leaf
+        {
+            PageGuard page = bm.pinPage(leafPage);
+            BPlusNode* node = page.as<BPlusNode>();
+            int* keys = node->keys();
+            int i = KeySearch::lowerBound(keys, node->numKeys, key);
+            if (i == node->numKeys || keys[i] != key) {
+                TRACE(TRACE_LEVEL_INFO, "[TREE] Key %d not found", key);
+                return false;
+            }
+            int* values = node->values(maxKeys);
+            for (; i < node->numKeys - 1; i++) {  // Close the gap
+                keys[i] = keys[i + 1];
+                values[i] = values[i + 1];
+            }
+            node->numKeys--;
+            page.markDirty();
+            TRACE(TRACE_LEVEL_INFO, "[TREE] Key %d removed from Leaf Page %d", key, leafPage);
+        }                                       // Unpin before rebalancing
+        rebalance(path, path.depth - 1);
+        return true;
+    }
+
+    // Builds the tree bottom-up from sorted input instead of inserting key by key. Leaves are
+    // packed to 'fillFactor' of maxKeys and appended to the file in large sequential writes,
+    // bypassing the buffer pool; each internal level is then built from the first keys of the
+    // level below, until one node is left to become the root. The tree must be empty.
+    // Returns the number of pairs loaded.
+    long bulkLoad(KeyValueSource& input, double fillFactor = 1.0) {
+        TRACE(TRACE_LEVEL_INFO, "\n>>> USER COMMAND: BULK LOAD (fill factor %.2f) <<<", fillFactor);
+        if (fillFactor < 0.5 || fillFactor > 1.0)
+            throw invalid_argument("fillFactor must be between 0.5 and 1.0");
+        {
+            PageGuard page = bm.pinPage(rootPage);
+            BPlusNode* root = page.as<BPlusNode>();
+            if (!root->isLeaf || root->numKeys != 0) throw runtime_error("bulkLoad needs an empty tree");
+        }
+        int perNode = max(1, (int)(fillFactor * maxKeys)); // Keys per packed node
+        int firstPage = bm.getNextPageID();     // Appended pages are only published at the end
+        vector<pair<int, int>> level;           // (first key, PageID) of every node on the last level built
+        long loaded = 0;
+        try {
+            PageBatch batch(bm);
+            int key, value, pageID, last = 0;
+            BPlusNode* leaf = nullptr;
+            while (input.next(key, value)) {
+                if (loaded > 0 && key <= last)      // Keys are unique and must arrive sorted
+                    throw invalid_argument("bulkLoad input must be in strictly ascending key order");
+                if (!leaf || leaf->numKeys == perNode) {    // Current leaf packed: start the next one
+                    leaf = batch.add(pageID);
+                    leaf->isLeaf = true;
+                    leaf->nextLeaf = -1;
+                    if (!level.empty()) batch.newest(1)->nextLeaf = pageID; // Chain the leaves in order
+                    level.push_back(make_pair(key, pageID));
+                }
+                leaf->keys()[leaf->numKeys] = key;
+                leaf->values(maxKeys)[leaf->numKeys++] = value;
+                last = key;
+                loaded++;
+            }
+            if (loaded == 0) return 0;              // Nothing to load: keep the empty root
+            BPlusNode* prev = batch.newest(1);
+            if (prev && leaf->numKeys < maxKeys / 2) { // Short last leaf: top it up from its neighbour
+                int move = min(maxKeys / 2 - leaf->numKeys, prev->numKeys - maxKeys / 2);
+                if (move > 0) {
+                    int* keys = leaf->keys();
+                    int* values = leaf->values(maxKeys);
+                    memmove(keys + move, keys, leaf->numKeys * sizeof(int));
+                    memmove(values + move, values, leaf->numKeys * sizeof(int));
+                    prev->numKeys -= move;
+                    memcpy(keys, prev->keys() + prev->numKeys, move * sizeof(int));
+                    memcpy(values, prev->values(maxKeys) + prev->numKeys, move * sizeof(int));
+                    leaf->numKeys += move;
+                    level.back().first = keys[0];
+                }
+            }
+
+            while (level.size() > 1) {              // One internal level per pass, bottom-up
+                int n = (int)level.size();
+                // Spread the children evenly: at least perNode + 1 per node, but never more than fit
+                int nodes = max(n / (perNode + 1), (n + maxKeys) / (maxKeys + 1));
+                nodes = max(nodes, 1);
+                vector<pair<int, int>> upper;
+                int next = 0;
+                for (int j = 0; j < nodes; j++) {
+                    int take = n / nodes + (j < n % nodes);
+                    BPlusNode* node = batch.add(pageID);
+                    node->isLeaf = false;
+                    node->nextLeaf = -1;
+                    node->numKeys = take - 1;
+                    int* keys = node->keys();
+                    int* children = node->children(maxKeys);
+                    for (int c = 0; c < take; c++) {
+                        if (c > 0) keys[c - 1] = level[next + c].first; // Separator: first key of the child
+                        children[c] = level[next + c].second;
+                    }
+                    upper.push_back(make_pair(level[next].first, pageID));
+                    next += take;
+                }
+                level.swap(upper);
+            }
+            batch.finish();
+        } catch (...) {
+            bm.header().nextPageID = firstPage;     // Nothing refers to the appended pages yet
+            throw;
+        }
+
+        int oldRoot = rootPage;                 // Past this point the new pages are published
+        setRoot(level[0].second);
+        rightmostValid = false;
+        bm.freePage(oldRoot);                   // The empty placeholder root is no longer used
+        TRACE(TRACE_LEVEL_INFO, "[TREE] Bulk load complete: %ld keys in %d pages, root Page %d.",
+              loaded, bm.getNextPageID() - firstPage, rootPage);
+        return loaded;
+    }
+
+    // Descends from the root to the leaf that can hold 'key', recording every step in 'path'
+    int findLeaf(int key, TreePath& path) {
+        path.depth = 0;
+        int currPage = rootPage;
+        while (true) {
+            if (path.depth == MAX_TREE_HEIGHT) throw runtime_error("B+ tree deeper than MAX_TREE_HEIGHT");
+            path.pages[path.depth] = currPage;
+            PageGuard page = bm.pinPage(currPage);               // Load node from buffer
+            BPlusNode* node = page.as<BPlusNode>();
+            if (node->isLeaf) {                                  // If it's a leaf, return its ID
+                path.depth++;
+                if (node->nextLeaf == -1) {                      // Remember the way to the rightmost leaf
+                    rightmost = path;
+                    rightmostMax = node->numKeys ? node->keys()[node->numKeys - 1] : INT_MIN; // Empty: the root
+                    rightmostValid = true;
+                }
+                return currPage;
+            }
+            page.setPriority(path.depth == 0 ? PagePriority::ROOT : PagePriority::INTERNAL); // Keep upper levels resident
+            int i = KeySearch::lowerBound(node->keys(), node->numKeys, key); // Navigation logic:
+            if (i < node->numKeys && node->keys()[i] == key) i++; // Equal keys live right of the separator
+            path.slots[path.depth++] = i;
+            currPage = node->children(maxKeys)[i];               // Guard unpins as the loop moves down
+        }
+    }
+
+    int findLeaf(int key) {                                      // Descent for reads: path not needed
+        TreePath path;
+        return findLeaf(key, path);
+    }
+
+    // Append fast path for ascending keys: a key above every key of the rightmost leaf can
+    // only belong there, so the cached path to that leaf replaces a descent from the root.
+    // The test runs on the cached key alone, so other inserts touch no extra page.
+    bool appendPath(int key, TreePath& path) {
+        if (!rightmostValid || key <= rightmostMax) return false;
+        path = rightmost;
+        TRACE(TRACE_LEVEL_DEBUG, "[TREE] Append fast path: Key %d goes to rightmost Leaf Page %d", key, path.leaf());
+        return true;
+    }
+
+    bool insertIntoLeaf(const TreePath& path, int key, int value, bool overwrite) {
+        int pageID = path.leaf();
+        {
+            PageGuard page = bm.pinPage(pageID);                 // Get leaf from buffer
+            BPlusNode* node = page.as<BPlusNode>();
+            int* keys = node->keys();
+            int* values = node->values(maxKeys);
+            int pos = KeySearch::lowerBound(keys, node->numKeys, key);
+            if (pos < node->numKeys && keys[pos] == key) {       // Keys are unique in the index
+                if (overwrite) {                                 // put(): replace the value in place
+                    values[pos] = value;
+                    page.markDirty();
+                    TRACE(TRACE_LEVEL_INFO, "[TREE] Key %d updated in Leaf Page %d", key, pageID);
+                } else {
+                    TRACE(TRACE_LEVEL_INFO, "[TREE] Key %d already present in Leaf Page %d", key, pageID);
+                }
+                return false;
+            }
+            if (node->numKeys < maxKeys) {                       // If room exists:
+                for (int i = node->numKeys; i > pos; i--) {      // Shift keys and values to maintain order
+                    keys[i] = keys[i - 1];
+                    values[i] = values[i - 1];
+                }
+                keys[pos] = key;                                 // Insert the new key
+                values[pos] = value;                             // ...and its value
+                node->numKeys++;                                 // Update key count
+                page.markDirty();                                // Mark page for disk write
+                if (pos == node->numKeys - 1 && rightmostValid && pageID == rightmost.leaf())
+                    rightmostMax = key;                          // Appended: the leaf's new maximum
+                TRACE(TRACE_LEVEL_INFO, "[TREE] Key %d placed in Leaf Page %d", key, pageID);
+                return true;
+            }
+        }                                                        // Unpin before splitting
+        splitLeaf(path, key, value);                             // Node full: trigger split
+        return true;
+    }
+
+    void splitLeaf(const TreePath& path, int key, int value) {
+        TRACE(TRACE_LEVEL_INFO, "[TREE] Node full! Initiating B+ Tree Split Logic...");
+        int oldPageID = path.leaf();
+        int newPageID = bm.allocatePage();   // Allocate new sibling page
+        int separator;
+        bool append;                         // New key lands past the end of the whole tree
+        rightmostValid = false;              // The rightmost leaf is about to change
+        {
+            PageGuard oldPage = bm.pinPage(oldPageID); // Both halves stay pinned while keys move
+            PageGuard newPage = bm.pinPage(newPageID);
+            BPlusNode* oldNode = oldPage.as<BPlusNode>(); // Get old node
+            BPlusNode* newNode = newPage.as<BPlusNode>(); // Get new sibling
+
+            newNode->isLeaf = true;              // Sibling is a leaf
+            append = oldNode->nextLeaf == -1 && oldNode->keys()[maxKeys - 1] < key;
+            newNode->nextLeaf = oldNode->nextLeaf; // Splice sibling into the leaf chain
+            oldNode->nextLeaf = newPageID;       // Old leaf now links to its new right neighbour
+
+            // The keys are already sorted: place the new pair by position instead of sorting
+            // a copy, moving each half with one memmove per array and no heap allocation
+            int* oldKeys = oldNode->keys();
+            int* oldValues = oldNode->values(maxKeys);
+            int* newKeys = newNode->keys();
+            int* newValues = newNode->values(maxKeys);
+            int pos = KeySearch::lowerBound(oldKeys, maxKeys, key); // Slot of the new key in the overflowed set
+            // Split point: half-full, except for appends, where the old leaf stays full and the
+            // new rightmost leaf starts with just the new key (ascending ingest fills every leaf)
+            int mid = append ? maxKeys : (maxKeys + 1) / 2;
+            newNode->numKeys = (maxKeys + 1) - mid; // Second half goes to the new node
+            if (pos < mid) {                     // New key stays left: one old key spills right
+                memcpy(newKeys, oldKeys + mid - 1, newNode->numKeys * sizeof(int));
+                memcpy(newValues, oldValues + mid - 1, newNode->numKeys * sizeof(int));
+                memmove(oldKeys + pos + 1, oldKeys + pos, (mid - 1 - pos) * sizeof(int));
+                memmove(oldValues + pos + 1, oldValues + pos, (mid - 1 - pos) * sizeof(int));
+                oldKeys[pos] = key;
+                oldValues[pos] = value;
+            } else {                             // New key goes right, between the moved runs
+                int before = pos - mid;          // Old keys that precede it in the sibling
+                memcpy(newKeys, oldKeys + mid, before * sizeof(int));
+                memcpy(newValues, oldValues + mid, before * sizeof(int));
+                newKeys[before] = key;
+                newValues[before] = value;
+                memcpy(newKeys + before + 1, oldKeys + pos, (maxKeys - pos) * sizeof(int));
+                memcpy(newValues + before + 1, oldValues + pos, (maxKeys - pos) * sizeof(int));
+            }
+            oldNode->numKeys = mid;              // First half stays in the old node
+
+            oldPage.markDirty();                 // Save changes to old node
+            newPage.markDirty();                 // Save changes to new sibling
+            separator = newNode->keys()[0];      // First key of the sibling goes up
+        }
+        TRACE(TRACE_LEVEL_INFO, "[TREE] Split complete. New Leaf Page %d created.", newPageID);
+
+        insertIntoParent(path, path.depth - 1, separator, newPageID, append); // Push middle key to parent
+        if (append) {                        // Cache the way to the new rightmost leaf for the next append
+            TreePath fresh;
+            findLeaf(key, fresh);
+        }
+    }
+
+    // Links 'right', the new sibling of the node at path level 'level', into that node's parent.
+    // 'append' marks a split of the rightmost node on its level caused by an ascending key.
+    void insertIntoParent(const TreePath& path, int level, int key, int right, bool append) {
+        int left = path.pages[level];
+        if (level == 0) {                    // If root was split, create new root
+            int newRoot = bm.allocatePage(); // Get page for new top node
+            {
+                PageGuard page = bm.pinPage(newRoot);
+                BPlusNode* r = page.as<BPlusNode>(); // Get struct pointer
+                r->isLeaf = false;               // New root is an Internal Node
+                r->nextLeaf = -1;                // Internal nodes are not chained
+                r->keys()[0] = key;              // Store the promoted key
+                r->children(maxKeys)[0] = left;  // Left pointer points to old root
+                r->children(maxKeys)[1] = right; // Right pointer points to new sibling
+                r->numKeys = 1;                  // New root starts with 1 key
+                page.markDirty();
+            }
+            setRoot(newRoot);                // Update tree root ID
+            TRACE(TRACE_LEVEL_INFO, "[TREE] New Root created (Page %d). Tree height increased!", newRoot);
+            return;
+        }
+
+        int parentPage = path.pages[level - 1]; // Climb one level along the recorded path
+        int pos = path.slots[level - 1];     // 'left' is child 'pos' of the parent
+        {
+            PageGuard page = bm.pinPage(parentPage);
+            BPlusNode* parent = page.as<BPlusNode>();
+            if (parent->numKeys < maxKeys) { // If room exists in the parent:
+                int* keys = parent->keys();
+                int* children = parent->children(maxKeys);
+                int moved = parent->numKeys - pos; // Shift keys/children right of 'left' by one slot
+                memmove(keys + pos + 1, keys + pos, moved * sizeof(int));
+                memmove(children + pos + 2, children + pos + 1, moved * sizeof(int));
+                keys[pos] = key;             // Separator goes right after 'left'
+                children[pos + 1] = right;   // New sibling follows the separator
+                parent->numKeys++;           // Update key count
+                page.markDirty();            // Mark page for disk write
+                TRACE(TRACE_LEVEL_INFO, "[TREE] Separator %d placed in Internal Page %d", key, parentPage);
+                return;
+            }
+        }                                    // Unpin before splitting
+        splitInternal(path, level - 1, key, right, append); // Parent full: split it too
+    }
+
+    // Splits the full internal node at path level 'level' while adding (key, right) after its child
+    void splitInternal(const TreePath& path, int level, int key, int right, bool append) {
+        int pageID = path.pages[level];
+        TRACE(TRACE_LEVEL_INFO, "[TREE] Internal node full! Splitting Page %d...", pageID);
+        vector<int> tempKeys, tempChildren;
+        {
+            PageGuard page = bm.pinPage(pageID); // Get the full internal node
+            BPlusNode* node = page.as<BPlusNode>();
+            tempKeys.assign(node->keys(), node->keys() + maxKeys);         // Copy existing keys
+            int* children = node->children(maxKeys);
+            tempChildren.assign(children, children + maxKeys + 1);         // And children
+        }
+        int pos = path.slots[level];         // Child that split, recorded on the way down
+        tempKeys.insert(tempKeys.begin() + pos, key);              // Separator after 'left'
+        tempChildren.insert(tempChildren.begin() + pos + 1, right); // New child after separator
+
+        int newPageID = bm.allocatePage();   // Allocate new sibling page
+        int mid = append ? maxKeys - 1 : (maxKeys + 1) / 2; // Key at 'mid' moves up, it is not kept below;
+                                             // appends keep the left node nearly full
+        int promoted = tempKeys[mid];        // Separator handed to the grandparent
+        {
+            PageGuard page = bm.pinPage(pageID);
+            PageGuard newPage = bm.pinPage(newPageID);
+            BPlusNode* node = page.as<BPlusNode>();
+            BPlusNode* newNode = newPage.as<BPlusNode>(); // Get new sibling
+
+            node->numKeys = mid;                 // Left half: keys [0, mid), children [0, mid]
+            for (int i = 0; i < mid; i++) node->keys()[i] = tempKeys[i];
+            for (int i = 0; i <= mid; i++) node->children(maxKeys)[i] = tempChildren[i];
+
+            newNode->isLeaf = false;             // Sibling is an internal node
+            newNode->nextLeaf = -1;              // Internal nodes are not chained
+            newNode->numKeys = maxKeys - mid;    // Right half: keys (mid, maxKeys]
+            for (int i = 0; i < newNode->numKeys; i++) newNode->keys()[i] = tempKeys[mid + 1 + i];
+            for (int i = 0; i <= newNode->numKeys; i++) newNode->children(maxKeys)[i] = tempChildren[mid + 1 + i];
+
+            page.markDirty();                    // Save changes to old node
+            newPage.markDirty();                 // Save changes to new sibling
+        }
+        TRACE(TRACE_LEVEL_INFO, "[TREE] Split complete. New Internal Page %d created.", newPageID);
+
+        insertIntoParent(path, level, promoted, newPageID, append); // Promote separator one level up
+    }
+
+    // Occupancy bound for non-root nodes. Midpoint splits leave both halves at or above it,
+    // but append splits start a new rightmost node with a single key, so the rightmost node
+    // of each level may hold fewer. rebalance() restores the bound on any node a removal
+    // leaves below it, the rightmost included.
+    int minKeys() const { return maxKeys / 2; }
+
+    // Restores the occupancy invariant of the node at path level 'level' after a removal,
+    // borrowing from or merging with an adjacent sibling and moving up the path when the
+    // parent loses a separator
+    void rebalance(const TreePath& path, int level) {
+        int pageID = path.pages[level];
+        if (level == 0) {                    // The root may shrink to any size...
+            int onlyChild = -1;
+            {
+                PageGuard page = bm.pinPage(pageID);
+                BPlusNode* root = page.as<BPlusNode>();
+                if (!root->isLeaf && root->numKeys == 0) onlyChild = root->children(maxKeys)[0];
+            }
+            if (onlyChild != -1) {           // ...but an internal root left with one child is dropped
+                setRoot(onlyChild);
+                bm.freePage(pageID);         // Old root page is recycled
+                TRACE(TRACE_LEVEL_INFO, "[TREE] Root collapsed into Page %d. Tree height decreased!", onlyChild);
+            }
+            return;
+        }
+
+        int parentPage = path.pages[level - 1];
+        bool isLeaf;
+        {
+            PageGuard page = bm.pinPage(pageID);
+            BPlusNode* node = page.as<BPlusNode>();
+            if (node->numKeys >= minKeys()) return; // Still at least half full: nothing to do
+            isLeaf = node->isLeaf;
+        }
+
+        int sepIdx, sibling;                 // Separator between the pair and the sibling's PageID
+        bool siblingIsLeft;
+        int separator;
+        {
+            PageGuard page = bm.pinPage(parentPage);
+            BPlusNode* parent = page.as<BPlusNode>();
+            int* children = parent->children(maxKeys);
+            int idx = path.slots[level - 1]; // Position of this node, recorded on the way down
+            siblingIsLeft = idx > 0;         // Prefer the left sibling; the leftmost child uses its right one
+            sepIdx = siblingIsLeft ? idx - 1 : idx;
+            sibling = siblingIsLeft ? children[idx - 1] : children[idx + 1];
+            separator = parent->keys()[sepIdx];
+        }
+        int leftPage = siblingIsLeft ? sibling : pageID;
+        int rightPage = siblingIsLeft ? pageID : sibling;
+
+        bool merged;
+        int newSeparator = separator;        // Replacement separator when keys are borrowed
+        {
+            PageGuard lPage = bm.pinPage(leftPage);
+            PageGuard rPage = bm.pinPage(rightPage);
+            BPlusNode* l = lPage.as<BPlusNode>();
+            BPlusNode* r = rPage.as<BPlusNode>();
+            int* lKeys = l->keys();
+            int* rKeys = r->keys();
+            int* lKids = l->children(maxKeys);
+            int* rKids = r->children(maxKeys);
+
+            if (isLeaf) {                    // Leaf values (kids slots) travel with their keys
+                merged = l->numKeys + r->numKeys <= maxKeys;
+                if (merged) {                // Right leaf folds into the left one
+                    for (int i = 0; i < r->numKeys; i++) {
+                        lKeys[l->numKeys + i] = rKeys[i];
+                        lKids[l->numKeys + i] = rKids[i];
+                    }
+                    l->numKeys += r->numKeys;
+                    l->nextLeaf = r->nextLeaf; // Unlink the right leaf from the chain
+                } else if (siblingIsLeft) {  // Borrow the left sibling's largest key
+                    for (int i = r->numKeys; i > 0; i--) {
+                        rKeys[i] = rKeys[i - 1];
+                        rKids[i] = rKids[i - 1];
+                    }
+                    l->numKeys--;
+                    rKeys[0] = lKeys[l->numKeys];
+                    rKids[0] = lKids[l->numKeys];
+                    r->numKeys++;
+                    newSeparator = rKeys[0];
+                } else {                     // Borrow the right sibling's smallest key
+                    lKeys[l->numKeys] = rKeys[0];
+                    lKids[l->numKeys] = rKids[0];
+                    l->numKeys++;
+                    for (int i = 0; i < r->numKeys - 1; i++) {
+                        rKeys[i] = rKeys[i + 1];
+                        rKids[i] = rKids[i + 1];
+                    }
+                    r->numKeys--;
+                    newSeparator = rKeys[0];
+                }
+            } else {
+                merged = l->numKeys + r->numKeys + 1 <= maxKeys;
+                if (merged) {                // Separator comes down between the two halves
+                    lKeys[l->numKeys] = separator;
+                    for (int i = 0; i < r->numKeys; i++) lKeys[l->numKeys + 1 + i] = rKeys[i];
+                    for (int i = 0; i <= r->numKeys; i++) lKids[l->numKeys + 1 + i] = rKids[i];
+                    l->numKeys += r->numKeys + 1;
+                } else if (siblingIsLeft) {  // Rotate right through the parent
+                    for (int i = r->numKeys; i > 0; i--) rKeys[i] = rKeys[i - 1];
+                    for (int i = r->numKeys + 1; i > 0; i--) rKids[i] = rKids[i - 1];
+                    rKeys[0] = separator;
+                    rKids[0] = lKids[l->numKeys];
+                    newSeparator = lKeys[l->numKeys - 1];
+                    l->numKeys--;
+                    r->numKeys++;
+                } else {                     // Rotate left through the parent
+                    lKeys[l->numKeys] = separator;
+                    lKids[l->numKeys + 1] = rKids[0];
+                    newSeparator = rKeys[0];
+                    for (int i = 0; i < r->numKeys - 1; i++) rKeys[i] = rKeys[i + 1];
+                    for (int i = 0; i < r->numKeys; i++) rKids[i] = rKids[i + 1];
+                    l->numKeys++;
+                    r->numKeys--;
+                }
+            }
+            lPage.markDirty();
+            rPage.markDirty();
+        }
+
+        {
+            PageGuard page = bm.pinPage(parentPage);
+            BPlusNode* parent = page.as<BPlusNode>();
+            int* keys = parent->keys();
+            int* children = parent->children(maxKeys);
+            if (merged) {                    // Drop the separator and the emptied right node
+                for (int i = sepIdx; i < parent->numKeys - 1; i++) keys[i] = keys[i + 1];
+                for (int i = sepIdx + 1; i < parent->numKeys; i++) children[i] = children[i + 1];
+                parent->numKeys--;
+            } else {
+                keys[sepIdx] = newSeparator; // Borrowing moved the boundary between the pair
+            }
+            page.markDirty();
+        }
+
+        if (merged) {
+            TRACE(TRACE_LEVEL_INFO, "[TREE] Page %d merged into Page %d.", rightPage, leftPage);
+            bm.freePage(rightPage);          // Emptied right node is recycled
+            rebalance(path, level - 1);      // Parent lost a key: it may underflow in turn
+        } else {
+            TRACE(TRACE_LEVEL_INFO, "[TREE] Page %d borrowed a key from Page %d.", pageID, sibling);
+        }
+    }
+};
+
+#endif
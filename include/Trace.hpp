@@ -0,0 +1,92 @@
+#ifndef TRACE_HPP
+#define TRACE_HPP
+
+#include <atomic>       // Lock-free ticket counter and per-entry sequence numbers
+#include <cstdarg>      // Variadic arguments for printf-style trace messages
+#include <cstdint>      // Fixed-width sequence counters
+#include <cstdio>       // vsnprintf formats messages straight into ring entries
+#include <cstring>      // memcpy when the reader snapshots an entry
+#include <ostream>      // Destination stream when the ring is drained
+
+using namespace std;    // Matches the engine headers
+
+// --- TRACE LEVELS ---
+#define TRACE_LEVEL_OFF   0     // Nothing is recorded; every TRACE() compiles to nothing
+#define TRACE_LEVEL_INFO  1     // User commands, allocations, evictions and tree structure changes
+#define TRACE_LEVEL_DEBUG 2     // Additionally every buffer hit/miss and disk read/write
+
+// Production builds leave tracing off; debug builds pass -DSTORAGE_TRACE_LEVEL=2
+#ifndef STORAGE_TRACE_LEVEL
+#define STORAGE_TRACE_LEVEL TRACE_LEVEL_OFF
+#endif
+
+// --- TRACE RING BUFFER ---
+// Fixed-size ring of formatted messages. Writers claim a slot with one atomic
+// fetch_add and never block; the oldest entries are overwritten when the ring wraps.
+// drain() prints everything recorded since the previous drain, in order.
+class TraceBuffer {
+public:
+    static const size_t CAPACITY = 4096;     // Entries in the ring (power of two)
+    static const size_t MESSAGE_SIZE = 120;  // Longer messages are truncated
+
+private:
+    struct Entry {
+        atomic<uint64_t> seq{0};             // 2*ticket+1 while writing, 2*ticket+2 once complete
+        char message[MESSAGE_SIZE];          // Formatted, NUL-terminated text
+    };
+    Entry entries[CAPACITY];
+    atomic<uint64_t> head{0};                // Next ticket handed to a writer
+    uint64_t tail = 0;                       // Next ticket the (single) reader will print
+
+public:
+    static TraceBuffer& instance() {
+        static TraceBuffer buffer;           // One ring per process, created on first use
+        return buffer;
+    }
+
+    void record(const char* format, ...) {
+        uint64_t ticket = head.fetch_add(1, memory_order_relaxed); // Claim a slot
+        Entry& e = entries[ticket & (CAPACITY - 1)];
+        e.seq.store(2 * ticket + 1, memory_order_relaxed);         // Mark slot as being written
+        atomic_thread_fence(memory_order_release);
+        va_list args;
+        va_start(args, format);
+        vsnprintf(e.message, MESSAGE_SIZE, format, args);
+        va_end(args);
+        e.seq.store(2 * ticket + 2, memory_order_release);         // Publish the finished entry
+    }
+
+    // Prints completed entries to 'out'; returns how many were lost to ring overwrites
+    uint64_t drain(ostream& out) {
+        uint64_t lost = 0;
+        uint64_t end = head.load(memory_order_acquire);
+        if (end - tail > CAPACITY) {         // Writers lapped the reader: skip what is gone
+            lost += end - CAPACITY - tail;
+            tail = end - CAPACITY;
+        }
+        char copy[MESSAGE_SIZE];
+        for (; tail < end; tail++) {
+            Entry& e = entries[tail & (CAPACITY - 1)];
+            uint64_t done = 2 * tail + 2;
+            uint64_t before = e.seq.load(memory_order_acquire);
+            if (before < done) break;        // Writer still busy: resume at the next drain
+            memcpy(copy, e.message, MESSAGE_SIZE);
+            atomic_thread_fence(memory_order_acquire);
+            if (before != done || e.seq.load(memory_order_relaxed) != done) { lost++; continue; }
+            out << copy << '\n';             // No per-line flush
+        }
+        out.flush();                         // One flush per drain
+        return lost;
+    }
+};
+
+// --- TRACE MACRO ---
+// TRACE(level, printf-format, args...). Arguments are not evaluated when the level is compiled out.
+#if STORAGE_TRACE_LEVEL > TRACE_LEVEL_OFF
+#define TRACE(level, ...) \
+    do { if ((level) <= STORAGE_TRACE_LEVEL) TraceBuffer::instance().record(__VA_ARGS__); } while (0)
+#else
+#define TRACE(level, ...) do { } while (0)
+#endif
+
+#endif
@@ -0,0 +1,589 @@
+#ifndef VAR_KEY_TREE_HPP
+#define VAR_KEY_TREE_HPP
+
+#include "StorageEngine.hpp" // Buffer pool, page guards and the database header
+
+// --- SLOTTED PAGE LAYOUT ---
+// Nodes of the variable-length key tree. A slot directory grows up from the header while
+// the key bytes grow down from the end of the page; a node is full when the two meet.
+// Bytes shared by every key of a node are stored once, at the very end of the page,
+// and the slots only keep each key's remaining suffix.
+struct KeySlot {
+    uint16_t offset;               // Byte offset of the key suffix inside the page
+    uint16_t length;               // Suffix length in bytes (the node prefix is not repeated)
+    int32_t value;                 // Leaf: value of the key; internal: child holding keys >= this key
+};
+
+struct SlottedNode {
+    bool isLeaf;                   // Flag: True for leaf nodes, False for internal nodes
+    int numKeys;                   // Number of slots in the directory
+    int nextLeaf;                  // Linked list pointer to the next leaf sibling
+    int firstChild;                // Internal: child holding keys below the first slot's key
+    int heapStart;                 // Lowest byte used by key data; pageSize when the heap is empty
+    int freedBytes;                // Key bytes of removed slots, reclaimed by compaction
+    int prefixLength;              // Bytes shared by every key, stored at the end of the page
+
+    KeySlot* slots() { return (KeySlot*)(this + 1); }                 // Sorted slot directory
+    const char* keyAt(int i) { return (const char*)this + slots()[i].offset; } // Suffix of key i
+    int child(int i) { return i == 0 ? firstChild : slots()[i - 1].value; } // Internal: child i
+    const char* prefix(int pageSize) { return (const char*)this + pageSize - prefixLength; }
+    int freeSpace() {              // Gap between the slot directory and the key heap
+        return heapStart - (int)sizeof(SlottedNode) - numKeys * (int)sizeof(KeySlot);
+    }
+};
+
+// Key and value copied out of a node while it is rebuilt or split
+struct KeyEntry {
+    string key;
+    int value;
+    int bytes() const { return (int)key.size() + (int)sizeof(KeySlot); } // Space taken in a page
+};
+
+// Lexicographic byte order; a key sorts before every longer key it is a prefix of
+inline int compareKeys(const char* a, int aLen, const char* b, int bLen) {
+    int c = memcmp(a, b, min(aLen, bLen));
+    return c != 0 ? c : aLen - bLen;
+}
+
+// Number of leading bytes two keys have in common
+inline int commonPrefix(const char* a, int aLen, const char* b, int bLen) {
+    int n = min(aLen, bLen), i = 0;
+    while (i < n && a[i] == b[i]) i++;
+    return i;
+}
+
+// --- VARIABLE-LENGTH KEY B+ TREE ---
+// Same structure as BPlusTree (descent paths, leaf chain, unique keys with int values),
+// but keys are byte strings and nodes split when their bytes, not their key count, run out.
+// With EngineConfig::compressKeys, nodes store their common prefix once and leaf splits
+// promote the shortest separator that still divides the two halves.
+// It is a separate tree rather than a node format behind BPlusTree: BPlusTree's split,
+// borrow, merge, append and bulk-load code moves runs of fixed-width keys by count and
+// copies separators by value, while slotted nodes split by bytes, rebuild around a
+// shared prefix and promote truncated separators, so little of that code would survive
+// the abstraction. What both trees share lives below them: TreePath, page guards, the
+// buffer hints and the free list. A file holds one kind of tree (DbHeader::keyFormat).
+// VarKeyTree has no borrow/merge of partly filled nodes, append fast path or bulk loader.
+class VarKeyTree {
+    BufferManager& bm;             // Access to the memory management layer
+    int rootPage;                  // The PageID of the top-most node (Root)
+    int pageSize;                  // Bytes per page; bounds the key heap
+    int maxKeyLength;              // Longest key accepted, so every split leaves both halves room
+    bool compress;                 // Prefix compression and suffix truncation for new nodes
+
+public:
+    // --- RANGE ITERATOR ---
+    // Walks keys in ascending order along the nextLeaf chain, pinning one leaf at a time.
+    class Iterator {
+        const VarKeyTree* tree;    // Owning tree: buffer for the next leaf, key comparison
+        PageGuard leaf;            // Pin on the current leaf; empty once the range is exhausted
+        int slot;                  // Index of the current key inside the leaf
+        string hi;                 // Inclusive upper bound of the scan
+
+        void settle() {            // Move to the next valid key, hopping leaves as needed
+            while (leaf.get()) {
+                SlottedNode* node = leaf.as<SlottedNode>();
+                if (slot < node->numKeys) {          // Key available in this leaf:
+                    if (tree->compareAt(node, slot, hi) > 0) leaf.release(); // Past the upper bound: stop
+                    return;
+                }
+                int next = node->nextLeaf;           // Leaf exhausted: follow sibling link
+                leaf.release();                      // Unpin before pinning the sibling
+                if (next != -1) leaf = tree->bm.pinPage(next);
+                slot = 0;
+            }
+        }
+
+    public:
+        Iterator(const VarKeyTree& t, PageGuard start, int startSlot, const string& upper)
+            : tree(&t), leaf(std::move(start)), slot(startSlot), hi(upper) { settle(); }
+
+        bool valid() const { return leaf.get() != nullptr; } // False once past 'hi' or the last leaf
+        string key() const { return tree->keyOf(leaf.as<SlottedNode>(), slot); }
+        int value() const { return leaf.as<SlottedNode>()->slots()[slot].value; }
+        void next() { slot++; settle(); }            // Advance to the following key
+    };
+
+    // Longest key for which any full node can still be split into two that fit
+    static int maxKeySize(int pageSize) {
+        return (pageSize - (int)sizeof(SlottedNode)) / 4 - (int)sizeof(KeySlot);
+    }
+
+    VarKeyTree(BufferManager& b, const EngineConfig& config = EngineConfig())
+        : bm(b), compress(config.compressKeys) {
+        config.validate();
+        pageSize = bm.getPageSize();
+        maxKeyLength = maxKeySize(pageSize);
+        DbHeader& hdr = bm.header();
+        if (hdr.rootPage != -1) {      // Existing database: pick up the persisted tree
+            if (hdr.keyFormat != KEY_FORMAT_BYTES)
+                throw runtime_error("database holds a tree with a different key format");
+            rootPage = hdr.rootPage;
+            return;
+        }
+        hdr.keyFormat = KEY_FORMAT_BYTES;
+        setRoot(bm.allocatePage());    // Initialize the tree with an empty leaf root
+        PageGuard page = bm.pinPage(rootPage);
+        initNode(page.as<SlottedNode>(), true);
+        page.markDirty();
+    }
+
+    void setRoot(int pageID) {
+        rootPage = pageID;             // Update tree root ID...
+        bm.header().rootPage = pageID; // ...and the copy persisted in the header page
+    }
+
+    int height() {                             // Levels from root to leaf; 1 for a lone root leaf
+        int levels = 1;
+        PageGuard page = bm.pinPage(rootPage);
+        while (!page.as<SlottedNode>()->isLeaf) {
+            int child = page.as<SlottedNode>()->firstChild;
+            page.release();
+            page = bm.pinPage(child);
+            levels++;
+        }
+        return levels;
+    }
+
+    bool insert(const string& key, int value = 0) { // Adds a new key; an existing key is left untouched
+        TRACE(TRACE_LEVEL_INFO, "\n>>> USER COMMAND: INSERT '%.*s' <<<", (int)key.size(), key.data());
+        checkKey(key);
+        TreePath path;
+        findLeaf(key, path);
+        return insertIntoLeaf(path, key, value, false);
+    }
+
+    bool put(const string& key, int value) {   // Upsert; returns true if the key was new
+        TRACE(TRACE_LEVEL_INFO, "\n>>> USER COMMAND: PUT '%.*s' = %d <<<", (int)key.size(), key.data(), value);
+        checkKey(key);
+        TreePath path;
+        findLeaf(key, path);
+        return insertIntoLeaf(path, key, value, true);
+    }
+
+    bool get(const string& key, int& value) {  // Copies the key's value out; false if absent
+        TRACE(TRACE_LEVEL_INFO, "\n>>> USER COMMAND: GET '%.*s' <<<", (int)key.size(), key.data());
+        return lookup(key, &value);
+    }
+
+    bool find(const string& key) {
+        TRACE(TRACE_LEVEL_INFO, "\n>>> USER COMMAND: FIND '%.*s' <<<", (int)key.size(), key.data());
+        return lookup(key, nullptr);
+    }
+
+    bool lookup(const string& key, int* value) {
+        PageGuard page = bm.pinPage(findLeaf(key)); // Only one leaf can hold the key
+        SlottedNode* node = page.as<SlottedNode>();
+        bool found;
+        int i = search(node, key, found);
+        if (found && value) *value = node->slots()[i].value;
+        return found;
+    }
+
+    Iterator scan(const string& lo, const string& hi) {
+        TRACE(TRACE_LEVEL_INFO, "\n>>> USER COMMAND: SCAN ['%.*s', '%.*s'] <<<",
+              (int)lo.size(), lo.data(), (int)hi.size(), hi.data());
+        PageGuard page = bm.pinPage(findLeaf(lo)); // Single descent to the first candidate leaf
+        bool found;
+        int i = search(page.as<SlottedNode>(), lo, found);   // First key >= lo
+        return Iterator(*this, std::move(page), i, hi);
+    }
+
+    // Removes the key from its leaf. Partly filled nodes are not merged: the freed bytes are
+    // reclaimed by compaction when the leaf next runs out of room. A leaf left empty is
+    // unlinked from the chain and its parent and recycled, see removeEmpty().
+    bool remove(const string& key) {
+        TRACE(TRACE_LEVEL_INFO, "\n>>> USER COMMAND: REMOVE '%.*s' <<<", (int)key.size(), key.data());
+        TreePath path;
+        int leafPage = findLeaf(key, path);
+        bool empty;
+        {
+            PageGuard page = bm.pinPage(leafPage);
+            SlottedNode* node = page.as<SlottedNode>();
+            bool found;
+            int i = search(node, key, found);
+            if (!found) return false;
+            removeSlot(node, i);
+            page.markDirty();
+            empty = node->numKeys == 0;
+            TRACE(TRACE_LEVEL_INFO, "[TREE] Key removed from Leaf Page %d", leafPage);
+        }                                       // Unpin before restructuring
+        if (empty && path.depth > 1) removeEmpty(path, path.depth - 1); // An empty root leaf stays
+        return true;
+    }
+
+    void checkKey(const string& key) const {
+        if ((int)key.size() > maxKeyLength)
+            throw invalid_argument("key is longer than " + to_string(maxKeyLength) + " bytes");
+    }
+
+    // Binary search over the slot directory: index of the first key >= 'key'
+    int search(SlottedNode* node, const string& key, bool& found) const {
+        found = false;
+        int p = node->prefixLength;    // Every key of the node starts with the prefix:
+        int c = memcmp(node->prefix(pageSize), key.data(), min(p, (int)key.size()));
+        if (c > 0 || (c == 0 && (int)key.size() < p)) return 0;  // 'key' sorts before all of them
+        if (c < 0) return node->numKeys;                          // ...or after all of them
+        const char* rest = key.data() + p;                        // Only suffixes are compared below
+        int restLen = (int)key.size() - p;
+        int lo = 0, hi = node->numKeys;
+        while (lo < hi) {
+            int mid = (lo + hi) / 2;
+            if (compareKeys(node->keyAt(mid), node->slots()[mid].length, rest, restLen) < 0)
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+        found = lo < node->numKeys && compareKeys(node->keyAt(lo), node->slots()[lo].length, rest, restLen) == 0;
+        return lo;
+    }
+
+    // Compares the full key in 'slot' (prefix + suffix) with 'key'
+    int compareAt(SlottedNode* node, int slot, const string& key) const {
+        int p = node->prefixLength;
+        int c = memcmp(node->prefix(pageSize), key.data(), min(p, (int)key.size()));
+        if (c != 0) return c;
+        if ((int)key.size() < p) return 1;
+        return compareKeys(node->keyAt(slot), node->slots()[slot].length, key.data() + p, (int)key.size() - p);
+    }
+
+    string keyOf(SlottedNode* node, int slot) const { // Rebuilds the full key of 'slot'
+        string key(node->prefix(pageSize), node->prefixLength);
+        key.append(node->keyAt(slot), node->slots()[slot].length);
+        return key;
+    }
+
+    // Descends from the root to the leaf that can hold 'key', recording every step in 'path'.
+    // Child index i is firstChild for i == 0 and slot i - 1's child otherwise.
+    int findLeaf(const string& key, TreePath& path) {
+        path.depth = 0;
+        int currPage = rootPage;
+        while (true) {
+            if (path.depth == MAX_TREE_HEIGHT) throw runtime_error("B+ tree deeper than MAX_TREE_HEIGHT");
+            path.pages[path.depth] = currPage;
+            PageGuard page = bm.pinPage(currPage);               // Load node from buffer
+            SlottedNode* node = page.as<SlottedNode>();
+            if (node->isLeaf) {                                  // If it's a leaf, return its ID
+                path.depth++;
+                return currPage;
+            }
+            page.setPriority(path.depth == 0 ? PagePriority::ROOT : PagePriority::INTERNAL); // Keep upper levels resident
+            bool found;
+            int i = search(node, key, found);                    // Equal keys live right of the separator
+            if (found) i++;
+            path.slots[path.depth++] = i;
+            currPage = node->child(i);
+        }
+    }
+
+    int findLeaf(const string& key) {                            // Descent for reads: path not needed
+        TreePath path;
+        return findLeaf(key, path);
+    }
+
+    bool insertIntoLeaf(const TreePath& path, const string& key, int value, bool overwrite) {
+        int pageID = path.leaf();
+        {
+            PageGuard page = bm.pinPage(pageID);                 // Get leaf from buffer
+            SlottedNode* node = page.as<SlottedNode>();
+            bool found;
+            int i = search(node, key, found);
+            if (found) {                                         // Keys are unique in the index
+                if (overwrite) {
+                    node->slots()[i].value = value;
+                    page.markDirty();
+                }
+                return false;
+            }
+            if (makeRoom(node, key)) {                           // If room exists (possibly after a rebuild):
+                insertKey(node, i, key, value);
+                page.markDirty();
+                TRACE(TRACE_LEVEL_INFO, "[TREE] Key '%.*s' placed in Leaf Page %d", (int)key.size(), key.data(), pageID);
+                return true;
+            }
+        }                                                        // Unpin before splitting
+        splitLeaf(path, key, value);                             // Node full: trigger split
+        return true;
+    }
+
+    void splitLeaf(const TreePath& path, const string& key, int value) {
+        int oldPageID = path.leaf();
+        TRACE(TRACE_LEVEL_INFO, "[TREE] Leaf Page %d out of space! Splitting by bytes...", oldPageID);
+        int newPageID = bm.allocatePage();   // Allocate new sibling page
+        string separator;
+        {
+            PageGuard oldPage = bm.pinPage(oldPageID); // Both halves stay pinned while keys move
+            PageGuard newPage = bm.pinPage(newPageID);
+            SlottedNode* oldNode = oldPage.as<SlottedNode>();
+            SlottedNode* newNode = newPage.as<SlottedNode>();
+
+            vector<KeyEntry> entries = readEntries(oldNode); // Existing pairs plus the new one, in order
+            bool found;
+            int pos = search(oldNode, key, found);
+            entries.insert(entries.begin() + pos, KeyEntry{key, value});
+            size_t mid = splitPoint(entries, 1, entries.size() - 1);
+
+            initNode(newNode, true);
+            newNode->nextLeaf = oldNode->nextLeaf;        // Splice sibling into the leaf chain
+            initNode(oldNode, true);
+            oldNode->nextLeaf = newPageID;
+            writeEntries(oldNode, entries, 0, mid);       // Lower half of the bytes stays put
+            writeEntries(newNode, entries, mid, entries.size());
+
+            oldPage.markDirty();
+            newPage.markDirty();
+            separator = entries[mid].key;                 // First key of the sibling goes up...
+            if (compress) {                               // ...cut to the bytes that tell the halves apart
+                const string& last = entries[mid - 1].key;
+                separator.resize(commonPrefix(last.data(), (int)last.size(), separator.data(), (int)separator.size()) + 1);
+            }
+        }
+        TRACE(TRACE_LEVEL_INFO, "[TREE] Split complete. New Leaf Page %d created.", newPageID);
+        insertIntoParent(path, path.depth - 1, separator, newPageID);
+    }
+
+    // Links 'right', the new sibling of the node at path level 'level', into that node's parent
+    void insertIntoParent(const TreePath& path, int level, const string& key, int right) {
+        int left = path.pages[level];
+        if (level == 0) {                    // If root was split, create new root
+            int newRoot = bm.allocatePage();
+            {
+                PageGuard page = bm.pinPage(newRoot);
+                SlottedNode* r = page.as<SlottedNode>();
+                initNode(r, false);              // New root is an Internal Node
+                r->firstChild = left;            // Old root holds the keys below the separator
+                insertKey(r, 0, key, right);
+                page.markDirty();
+            }
+            setRoot(newRoot);
+            TRACE(TRACE_LEVEL_INFO, "[TREE] New Root created (Page %d). Tree height increased!", newRoot);
+            return;
+        }
+
+        int parentPage = path.pages[level - 1]; // Climb one level along the recorded path
+        {
+            PageGuard page = bm.pinPage(parentPage);
+            SlottedNode* parent = page.as<SlottedNode>();
+            if (makeRoom(parent, key)) {     // 'left' is child i, so the separator becomes slot i
+                insertKey(parent, path.slots[level - 1], key, right);
+                page.markDirty();
+                TRACE(TRACE_LEVEL_INFO, "[TREE] Separator placed in Internal Page %d", parentPage);
+                return;
+            }
+        }                                    // Unpin before splitting
+        splitInternal(path, level - 1, key, right);
+    }
+
+    // Splits the full internal node at path level 'level' while adding (key, right) after its child
+    void splitInternal(const TreePath& path, int level, const string& key, int right) {
+        int pageID = path.pages[level];
+        TRACE(TRACE_LEVEL_INFO, "[TREE] Internal node out of space! Splitting Page %d...", pageID);
+        vector<KeyEntry> entries;            // (separator, right child) pairs in order
+        int firstChild;
+        {
+            PageGuard page = bm.pinPage(pageID);
+            SlottedNode* node = page.as<SlottedNode>();
+            entries = readEntries(node);
+            firstChild = node->firstChild;
+            entries.insert(entries.begin() + path.slots[level], KeyEntry{key, right});
+        }
+
+        int newPageID = bm.allocatePage();   // Allocate new sibling page
+        size_t mid = splitPoint(entries, 1, entries.size() - 2); // Key at 'mid' moves up
+        string promoted = entries[mid].key;
+        {
+            PageGuard page = bm.pinPage(pageID);
+            PageGuard newPage = bm.pinPage(newPageID);
+            SlottedNode* node = page.as<SlottedNode>();
+            SlottedNode* newNode = newPage.as<SlottedNode>();
+
+            initNode(node, false);                        // Left half: firstChild, entries [0, mid)
+            node->firstChild = firstChild;
+            writeEntries(node, entries, 0, mid);
+
+            initNode(newNode, false);                     // Right half: entries (mid, end)
+            newNode->firstChild = entries[mid].value;
+            writeEntries(newNode, entries, mid + 1, entries.size());
+
+            page.markDirty();
+            newPage.markDirty();
+        }
+        TRACE(TRACE_LEVEL_INFO, "[TREE] Split complete. New Internal Page %d created.", newPageID);
+
+        insertIntoParent(path, level, promoted, newPageID);
+    }
+
+    // Drops the empty node at path level 'level', a leaf without keys or an internal node that
+    // lost its last child: a leaf is unlinked from the leaf chain, then the node is removed
+    // from its parent together with the separator in front of it and recycled. A parent
+    // left without children goes the same way, and an internal root left with a single
+    // child is collapsed into it.
+    void removeEmpty(const TreePath& path, int level) {
+        int pageID = path.pages[level];
+        bool isLeaf;
+        int nextLeaf;
+        {
+            PageGuard page = bm.pinPage(pageID);
+            isLeaf = page.as<SlottedNode>()->isLeaf;
+            nextLeaf = page.as<SlottedNode>()->nextLeaf;
+        }
+        if (isLeaf) {
+            int prev = previousLeaf(path);
+            if (prev != -1) {                // The leftmost leaf has no link pointing at it
+                PageGuard page = bm.pinPage(prev);
+                page.as<SlottedNode>()->nextLeaf = nextLeaf;
+                page.markDirty();
+            }
+        }
+
+        int parentPage = path.pages[level - 1];
+        bool parentEmpty;
+        {
+            PageGuard page = bm.pinPage(parentPage);
+            SlottedNode* parent = page.as<SlottedNode>();
+            int i = path.slots[level - 1];   // Position of this node, recorded on the way down
+            parentEmpty = parent->numKeys == 0; // It was the parent's only child
+            if (!parentEmpty) {
+                if (i == 0) parent->firstChild = parent->child(1); // Next child takes the low keys too
+                removeSlot(parent, i == 0 ? 0 : i - 1);
+                page.markDirty();
+            }
+        }
+        bm.freePage(pageID);                 // Emptied node is recycled
+        TRACE(TRACE_LEVEL_INFO, "[TREE] Empty Page %d removed from Internal Page %d.", pageID, parentPage);
+
+        if (parentEmpty && level > 1) removeEmpty(path, level - 1);
+        else collapseRoot();                 // The root keeps two children until it collapses
+    }
+
+    // Leaf before the one at the end of 'path' in key order; -1 for the leftmost leaf
+    int previousLeaf(const TreePath& path) {
+        for (int level = path.depth - 2; level >= 0; level--) {
+            if (path.slots[level] == 0) continue; // Leftmost child here: look one level up
+            int pageID;
+            {
+                PageGuard page = bm.pinPage(path.pages[level]);
+                pageID = page.as<SlottedNode>()->child(path.slots[level] - 1);
+            }
+            while (true) {                   // Rightmost leaf below the left neighbour
+                PageGuard page = bm.pinPage(pageID);
+                SlottedNode* node = page.as<SlottedNode>();
+                if (node->isLeaf) return pageID;
+                pageID = node->child(node->numKeys);
+            }
+        }
+        return -1;
+    }
+
+    void collapseRoot() {                    // Drops internal roots left with a single child
+        while (true) {
+            int onlyChild;
+            {
+                PageGuard page = bm.pinPage(rootPage);
+                SlottedNode* root = page.as<SlottedNode>();
+                if (root->isLeaf || root->numKeys > 0) return;
+                onlyChild = root->firstChild;
+            }
+            int oldRoot = rootPage;
+            setRoot(onlyChild);
+            bm.freePage(oldRoot);            // Old root page is recycled
+            TRACE(TRACE_LEVEL_INFO, "[TREE] Root collapsed into Page %d. Tree height decreased!", onlyChild);
+        }
+    }
+
+    // --- SLOTTED PAGE HELPERS ---
+    void initNode(SlottedNode* node, bool leaf) {
+        node->isLeaf = leaf;
+        node->numKeys = 0;
+        node->nextLeaf = -1;
+        node->firstChild = -1;
+        node->heapStart = pageSize;    // Key heap is empty
+        node->freedBytes = 0;
+        node->prefixLength = 0;
+    }
+
+    // True if 'key' fits in the node. A key that does not share the node's prefix, or holes left
+    // by removals, make the node rebuild itself around the new key first.
+    bool makeRoom(SlottedNode* node, const string& key) {
+        int p = node->prefixLength;
+        int keep = commonPrefix(node->prefix(pageSize), p, key.data(), (int)key.size());
+        if (keep == p && node->freeSpace() >= (int)key.size() - p + (int)sizeof(KeySlot)) return true;
+        if (!compress) keep = 0;                      // The rebuild drops the prefix altogether
+        int grown = (p - keep) * (node->numKeys - 1); // Suffixes lengthen, the stored prefix shrinks
+        int need = (int)key.size() - keep + (int)sizeof(KeySlot) + grown;
+        if (node->freeSpace() + node->freedBytes < need) return false;
+
+        vector<KeyEntry> entries = readEntries(node);
+        int firstChild = node->firstChild, nextLeaf = node->nextLeaf;
+        initNode(node, node->isLeaf);
+        node->firstChild = firstChild;
+        node->nextLeaf = nextLeaf;
+        if (compress && !entries.empty()) {           // Prefix of the keys plus the one on its way in
+            const string& lo = min(entries.front().key, key);
+            const string& hi = max(entries.back().key, key);
+            setPrefix(node, key.data(), commonPrefix(lo.data(), (int)lo.size(), hi.data(), (int)hi.size()));
+        }
+        for (const KeyEntry& e : entries) insertKey(node, node->numKeys, e.key, e.value);
+        return true;
+    }
+
+    // Stores the common prefix of an empty node at the end of its page
+    void setPrefix(SlottedNode* node, const char* bytes, int len) {
+        node->heapStart -= len;
+        memcpy((char*)node + node->heapStart, bytes, len);
+        node->prefixLength = len;
+    }
+
+    // Inserts a full key (which starts with the node prefix) as slot 'pos'
+    void insertKey(SlottedNode* node, int pos, const string& key, int value) {
+        int p = node->prefixLength;
+        insertSlot(node, pos, key.data() + p, (int)key.size() - p, value);
+    }
+
+    // Copies the suffix to the top of the heap and opens slot 'pos' for it; the caller checked the space
+    void insertSlot(SlottedNode* node, int pos, const char* key, int len, int value) {
+        node->heapStart -= len;
+        memcpy((char*)node + node->heapStart, key, len);
+        KeySlot* slots = node->slots();
+        memmove(slots + pos + 1, slots + pos, (node->numKeys - pos) * sizeof(KeySlot));
+        slots[pos].offset = (uint16_t)node->heapStart;
+        slots[pos].length = (uint16_t)len;
+        slots[pos].value = value;
+        node->numKeys++;
+    }
+
+    void removeSlot(SlottedNode* node, int pos) { // Closes slot 'pos'; its bytes wait for compaction
+        node->freedBytes += node->slots()[pos].length; // Only the suffix bytes become free
+        memmove(node->slots() + pos, node->slots() + pos + 1, (node->numKeys - pos - 1) * sizeof(KeySlot));
+        node->numKeys--;
+    }
+
+    vector<KeyEntry> readEntries(SlottedNode* node) {
+        vector<KeyEntry> entries;
+        entries.reserve(node->numKeys);
+        for (int i = 0; i < node->numKeys; i++) entries.push_back(KeyEntry{keyOf(node, i), node->slots()[i].value});
+        return entries;
+    }
+
+    // Fills an empty node with sorted entries [from, to), factoring out their common prefix
+    void writeEntries(SlottedNode* node, const vector<KeyEntry>& entries, size_t from, size_t to) {
+        if (compress && from < to) {
+            const string& lo = entries[from].key;
+            const string& hi = entries[to - 1].key;
+            setPrefix(node, lo.data(), commonPrefix(lo.data(), (int)lo.size(), hi.data(), (int)hi.size()));
+        }
+        for (size_t i = from; i < to; i++) insertKey(node, node->numKeys, entries[i].key, entries[i].value);
+    }
+
+    // First entry of the right half: the left half takes entries while it holds at most half the bytes
+    static size_t splitPoint(const vector<KeyEntry>& entries, size_t lo, size_t hi) {
+        int total = 0;
+        for (const KeyEntry& e : entries) total += e.bytes();
+        int acc = 0;
+        size_t i = 0;
+        while (i < entries.size() && acc + entries[i].bytes() <= total / 2) acc += entries[i++].bytes();
+        return max(lo, min(i, hi));
+    }
+};
+
+#endif
@@ -0,0 +1,7 @@
+#!/bin/bash
+# Builds every benchmark in bench/ with optimizations and runs it
+for src in bench/*.cpp; do
+    name=$(basename "$src" .cpp)
+    echo "=== $name ==="
+    g++ -O2 -I include "$src" -o "$name.out" && "./$name.out"
+done
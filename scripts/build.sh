@@ -1,3 +1,13 @@
 #!/bin/bash
-g++ -I include src/main.cpp -o build_output.exe
-./build_output.exe
\ No newline at end of file
+# Debug build: full engine trace (see tests/system_test_output.txt)
+g++ -DSTORAGE_TRACE_LEVEL=2 -I include src/main.cpp -o build_output.exe
+./build_output.exe
+# Randomized B+ tree model check (insert/remove/rebalance, free list, bulk load)
+g++ -O2 -I include tests/tree_stress.cpp -o tree_stress.exe
+./tree_stress.exe
+# Randomized VarKeyTree model check (prefix compression, separator truncation, empty-node removal)
+g++ -O2 -I include tests/varkey_stress.cpp -o varkey_stress.exe
+./varkey_stress.exe
+# Buffer pool checks (replacement policies)
+g++ -O2 -I include tests/buffer_test.cpp -o buffer_test.exe
+./buffer_test.exe
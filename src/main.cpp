@@ -1,4 +1,8 @@
 #include "../include/StorageEngine.hpp"
+#include <iostream>                         // Demo banners and results go to cout
+
+// Prints the engine trace recorded so far (empty unless built with -DSTORAGE_TRACE_LEVEL)
+static void showTrace() { TraceBuffer::instance().drain(cout); }
 
 // --- MAIN EXECUTION ---
 int main() {
@@ -6,19 +10,66 @@ int main() {
     cout << "   MINI-DBMS STORAGE ENGINE STARTING...    " << endl;
     cout << "===========================================" << endl;
 
-    StorageManager sm("database.db");       // Initialize disk storage file
-    BufferManager bm(sm);                   // Initialize memory manager
-    BPlusTree tree(bm);                     // Initialize the B+ Tree structure
+    EngineConfig config;                    // Demo settings: 4KB pages, 3 frames...
+    config.maxKeys = 3;                     // ...and 3 keys per node so splits show up quickly
+    config.truncate = true;                 // Start every demo from an empty database file
+    StorageManager sm("database.db", config); // Initialize disk storage file
+    BufferManager bm(sm, config);           // Initialize memory manager
+    BPlusTree tree(bm, config);             // Initialize the B+ Tree structure
 
     // Executing a sequence of inserts to demonstrate Buffer Hits, Misses, and Tree Splits
     tree.insert(10);                        // Simple insert
     tree.insert(20);                        // Simple insert
     tree.insert(30);                        // Fills the first leaf
-    tree.insert(40);                        // TRIGGERS SPLIT: Root becomes Internal Node
-    tree.insert(50);                        // TRIGGERS EVICTION: Page 0 or 1 will be kicked to disk
+    tree.insert(40);                        // TRIGGERS SPLIT: Root becomes Internal Node; an ascending
+                                            // key leaves Leaf 1 full and starts Leaf 2 with just 40,
+                                            // then caches the path to the new rightmost leaf
+    tree.insert(50);                        // APPEND FAST PATH: above Leaf 2's cached maximum, no descent
+    tree.insert(60);                        // APPEND FAST PATH again
+
+    // Point lookups and a range scan over the leaf chain
+    bool has30 = tree.find(30);             // Present key
+    showTrace();
+    cout << "[RESULT] Key 30 " << (has30 ? "found" : "missing") << endl;
+    bool has35 = tree.find(35);             // Absent key
+    showTrace();
+    cout << "[RESULT] Key 35 " << (has35 ? "found" : "missing") << endl;
+
+    // Key/value access: put() upserts the value stored next to the key in its leaf
+    tree.put(30, 300);                      // Existing keys: values replaced in place, no split
+    tree.put(50, 500);
+    int value = 0;
+    bool got30 = tree.get(30, value);
+    showTrace();
+    cout << "[RESULT] Key 30 -> " << (got30 ? to_string(value) : "missing") << endl;
+
+    for (BPlusTree::Iterator it = tree.scan(20, 45); it.valid(); it.next()) { // Walks Leaf 1 -> Leaf 2
+        int key = it.key();
+        int val = it.value();
+        showTrace();                        // Flush buffer traces before printing the result
+        cout << "[RESULT] Scan key " << key << " = " << val << endl;
+    }
+
+    // Deletions: emptying Leaf 1 merges the leaves back together
+    tree.remove(20);                        // Leaf 1 keeps two keys
+    tree.remove(10);                        // Leaf 1 keeps one key: still legal
+    tree.remove(30);                        // TRIGGERS MERGE: Leaf 2 folds into Leaf 1, root collapses
+    showTrace();
+
+    bm.checkpoint();                        // Write every dirty page and sync the file once
+    showTrace();
+
+    // Simulated restart: reopen the same file and find the tree through the header page
+    config.truncate = false;
+    StorageManager sm2("database.db", config);
+    BufferManager bm2(sm2, config);
+    BPlusTree reopened(bm2, config);
+    bool has50 = reopened.get(50, value);   // Pair written before the "restart"
+    showTrace();
+    cout << "[RESULT] Key 50 -> " << (has50 ? to_string(value) : "missing") << " after reopening" << endl;
 
     cout << "\n===========================================" << endl;
     cout << "   DEMO COMPLETE: CHECK database.db FILE   " << endl;
     cout << "===========================================" << endl;
     return 0;                               // Program finish
-}
\ No newline at end of file
+}
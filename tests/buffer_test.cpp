@@ -0,0 +1,488 @@
+#include "../include/StorageEngine.hpp"
+#include <iostream>                         // Progress lines and the failure report
+#include <random>                           // Access streams
+#include <functional>                       // Steps run under a file size limit
+#include <csignal>                          // Ignore SIGXFSZ while the file size is limited
+#include <sys/resource.h>                   // RLIMIT_FSIZE: a real write error for the writer
+
+// --- BUFFER POOL TEST ---
+// Behavioral checks of the replacement policies. A small harness replays page requests the
+// way BufferManager::fetchFrame does (onHit on a hit, the victim's frame refilled and
+// reported with onLoad on a miss) and moves frames in and out of a protected tier with
+// onRemove/onLoad, so each policy is checked against its own contract.
+// Usage: buffer_test [seed]   (default 1)
+
+const char* DB_FILE = "buffer_test.db";
+
+static void expect(bool ok, const string& what) {
+    if (!ok) throw runtime_error(what);
+}
+
+const Replacement POLICIES[] = {Replacement::LRU, Replacement::CLOCK, Replacement::CLOCK_PRO,
+                                Replacement::TWO_Q, Replacement::ARC};
+
+class PolicyHarness {
+public:
+    vector<Frame> frames;
+    unique_ptr<ReplacementPolicy> policy;
+    unordered_map<int, int> pageTable;      // PageID -> frame
+    size_t filled = 0;                      // Frames handed out before the policy picks victims
+    long misses = 0;
+
+    PolicyHarness(Replacement kind, size_t n) : frames(n) { policy = makePolicy(kind, frames); }
+
+    int access(int pageID) {                // Frame holding 'pageID' after the request
+        auto hit = pageTable.find(pageID);
+        if (hit != pageTable.end()) {
+            if (frames[hit->second].priority == PagePriority::NORMAL) policy->onHit(hit->second);
+            return hit->second;
+        }
+        misses++;
+        int idx = filled < frames.size() ? (int)filled++ : policy->victim(pageID);
+        expect(idx != -1, string(policy->name()) + " found no victim with unpinned frames");
+        if (frames[idx].pageID != -1) pageTable.erase(frames[idx].pageID);
+        frames[idx].pageID = pageID;
+        pageTable[pageID] = idx;
+        policy->onLoad(idx);
+        return idx;
+    }
+
+    void protect(int idx) {                 // Frame joins the protected tier
+        policy->onRemove(idx);
+        frames[idx].priority = PagePriority::INTERNAL;
+    }
+
+    void unprotect(int idx) {               // ...and goes back under the policy
+        frames[idx].priority = PagePriority::NORMAL;
+        policy->onLoad(idx);
+    }
+
+    void checkHistory() {                   // No resident page may still be listed as evicted
+        for (const auto& entry : pageTable)
+            expect(!policy->remembers(entry.first), string(policy->name()) + " keeps a ghost of resident page " +
+                   to_string(entry.first));
+    }
+};
+
+// With every frame pinned (or handed to the protected tier) victim() must give up with -1,
+// and once one frame is unpinned it must return exactly that frame
+static void allPinned() {
+    for (Replacement kind : POLICIES) {
+        PolicyHarness h(kind, 8);
+        for (int round = 0; round < 3; round++) // Hits, evictions and ghosts before pinning
+            for (int pageID = 0; pageID < 12; pageID++) h.access(pageID);
+        h.protect(h.pageTable.begin()->second);
+        for (Frame& f : h.frames) f.pinCount = 1;
+        string name = h.policy->name();
+        expect(h.policy->victim(500) == -1, name + " evicted a pinned frame");
+        expect(h.policy->victim(h.frames[0].pageID + 1) == -1, name + " evicted a pinned frame");
+        int freed = -1;
+        for (size_t i = 0; i < h.frames.size(); i++)
+            if (h.frames[i].priority == PagePriority::NORMAL) freed = (int)i;
+        h.frames[freed].pinCount = 0;
+        expect(h.policy->victim(501) == freed, name + " skipped the only unpinned frame");
+    }
+    cout << "victim with every frame pinned: ok" << endl;
+}
+
+// A hot set referenced often enough to prove reuse, then one pass over many more pages than
+// the pool holds: 2Q (and the other scan-resistant policies) keep the hot set, LRU does not
+static void scanResistance() {
+    const int HOT = 8;
+    for (Replacement kind : POLICIES) {
+        if (kind == Replacement::CLOCK) continue; // Like LRU, CLOCK is not meant to resist scans
+        PolicyHarness h(kind, 64);
+        int next = 1000;
+        for (int round = 0; round < 20; round++) {
+            for (int pageID = 0; pageID < HOT; pageID++) h.access(pageID);
+            for (int i = 0; i < 12; i++) h.access(next++); // Pages used once between references
+        }
+        for (int i = 0; i < 1000; i++) h.access(next++); // The scan
+        long before = h.misses;
+        for (int pageID = 0; pageID < HOT; pageID++) h.access(pageID);
+        long lost = h.misses - before;
+        if (kind == Replacement::LRU)
+            expect(lost == HOT, "LRU kept the hot set through the scan: the scan is too short");
+        else
+            expect(lost == 0, string(h.policy->name()) + " lost " + to_string(lost) + " hot pages to a scan");
+    }
+    cout << "hot set through a one-pass scan: ok" << endl;
+}
+
+// ARC's target p for T1 must grow when pages come back shortly after leaving T1 (recency)
+// and shrink when they come back after leaving T2 (frequency)
+static void arcAdapts() {
+    PolicyHarness h(Replacement::ARC, 64);
+    for (int pageID = 0; pageID < 40; pageID++) { // 40 frequent pages fill T2
+        h.access(pageID);
+        h.access(pageID);
+    }
+    int start = h.policy->adaptiveTarget();
+    for (int round = 0; round < 10; round++)   // Loop over 40 pages seen once: T1 is too small
+        for (int pageID = 1000; pageID < 1040; pageID++) h.access(pageID);
+    int recency = h.policy->adaptiveTarget();
+    expect(recency > start + 16, "ARC target moved from " + to_string(start) + " to " + to_string(recency) +
+           " under a recency workload");
+    for (int round = 0; round < 10; round++)   // The frequent pages return: T2 was too small
+        for (int pageID = 0; pageID < 40; pageID++) {
+            h.access(pageID);
+            h.access(pageID);
+        }
+    int frequency = h.policy->adaptiveTarget();
+    expect(frequency < recency - 16, "ARC target moved from " + to_string(recency) + " to " + to_string(frequency) +
+           " under a frequency workload");
+    cout << "ARC target: ok, " << start << " -> " << recency << " (recency) -> " << frequency << " (frequency)" << endl;
+}
+
+// Random requests mixed with moves in and out of the protected tier: a page removed from a
+// policy and loaded again, or evicted and loaded again, must not stay in its ghost history
+static void ghostHistory(unsigned seed) {
+    for (Replacement kind : POLICIES) {
+        PolicyHarness h(kind, 32);
+        mt19937 rng(seed);
+        vector<int> tier;                   // Protected frames, at most a quarter of the pool
+        for (int i = 0; i < 50000; i++) {
+            int op = rng() % 16;
+            if (op == 0 && h.filled == h.frames.size() && tier.size() < 8) { // Protect a resident frame
+                int idx = rng() % h.filled;
+                if (h.frames[idx].priority == PagePriority::NORMAL) {
+                    h.protect(idx);
+                    tier.push_back(idx);
+                }
+            } else if (op == 1 && !tier.empty()) { // Hand a protected frame back
+                int pick = rng() % tier.size();
+                h.unprotect(tier[pick]);
+                tier.erase(tier.begin() + pick);
+            } else {                        // Skewed requests: some pages return while still remembered
+                h.access(rng() % 2 ? rng() % 24 : rng() % 200);
+            }
+            if (i % 16 == 0) h.checkHistory();
+        }
+        h.checkHistory();
+
+        // Directed case: evicted with a ghost, reloaded, protected, handed back, evicted again
+        PolicyHarness d(kind, 4);
+        for (int pageID = 0; pageID < 8; pageID++) d.access(pageID);
+        d.access(0);                        // Back while remembered (if the policy remembers it)
+        d.checkHistory();
+        d.protect(d.pageTable[0]);
+        d.unprotect(d.pageTable[0]);
+        d.checkHistory();
+        for (int pageID = 100; pageID < 108; pageID++) d.access(pageID);
+        expect(!d.pageTable.count(0), string(d.policy->name()) + " never evicted page 0");
+        d.access(0);
+        d.checkHistory();
+    }
+    cout << "ghost history after onRemove and reloads: ok" << endl;
+}
+
+// A B+ tree several times larger than the pool: a full scan walks every leaf through the
+// policy, while the root, hinted ROOT on every descent, stays in the protected tier.
+// Without the tier (protectedShare 0) the same scan evicts it.
+static void rootSurvivesScan() {
+    for (Replacement kind : POLICIES) {
+        for (double share : {0.25, 0.0}) {
+            EngineConfig config;
+            config.truncate = true;
+            config.maxKeys = 16;
+            config.bufferFrames = 32;
+            config.replacement = kind;
+            config.protectedShare = share;
+            StorageManager sm(DB_FILE, config);
+            BufferManager bm(sm, config);
+            BPlusTree tree(bm, config);
+            for (int k = 0; k < 20000; k++) tree.insert(k, k);
+            expect(tree.height() >= 3, "tree too shallow to have internal pages");
+            tree.find(0);                   // Descent: the root gets its hint
+            BufferStats before = bm.stats();
+            long scanned = 0;
+            for (BPlusTree::Iterator it = tree.scan(0, 20000); it.valid(); it.next()) scanned++;
+            expect(scanned == 20000, "scan returned " + to_string(scanned) + " keys");
+            BufferStats after = bm.stats();
+            expect(after.evictions - before.evictions > 1000, "scan did not cycle the pool");
+            bm.fetchPage(bm.header().rootPage);
+            bool rootHit = bm.stats().misses == after.misses;
+            string name = string(bm.policyName()) + (share > 0 ? " with" : " without") + " a protected tier";
+            if (share > 0) {
+                expect(rootHit, name + " evicted the root during a leaf scan");
+                expect(after.protectedFrames >= 1 && after.protectedFrames <= 8, name + " holds " +
+                       to_string(after.protectedFrames) + " protected frames, the limit is 8");
+            } else if (kind == Replacement::LRU || kind == Replacement::CLOCK) {
+                expect(!rootHit, name + " kept the root: the scan is too short to show the tier's effect");
+            }
+        }
+    }
+    cout << "root through a leaf scan: ok" << endl;
+}
+
+// Tier bookkeeping on a 4-frame pool with room for 2 protected frames: a full tier hands its
+// oldest INTERNAL page back to the policy (never the root), and when every frame the policy
+// holds is pinned, eviction takes an internal page from the tier before the root.
+static void protectedTier() {
+    EngineConfig config;
+    config.truncate = true;
+    config.bufferFrames = 4;
+    config.protectedShare = 0.5;
+    StorageManager sm(DB_FILE, config);
+    BufferManager bm(sm, config);
+    for (int i = 0; i < 6; i++) bm.allocatePage(); // Pages 1..6
+    auto misses = [&bm] { return bm.stats().misses; };
+
+    {
+        PageGuard root = bm.pinPage(1);
+        root.setPriority(PagePriority::ROOT);
+        PageGuard a = bm.pinPage(2);
+        a.setPriority(PagePriority::INTERNAL);
+        PageGuard b = bm.pinPage(3);
+        b.setPriority(PagePriority::INTERNAL); // Tier full: page 2, the oldest internal, leaves it
+        expect(bm.stats().protectedFrames == 2, "tier holds " + to_string(bm.stats().protectedFrames) + " frames, limit 2");
+    }
+    {
+        PageGuard d = bm.pinPage(4);        // Take the policy's two frames: pages 6 and 2 leave,
+        PageGuard e = bm.pinPage(5);        // page 2 having been handed back to the policy
+        long before = misses();
+        bm.fetchPage(1);
+        bm.fetchPage(3);
+        expect(misses() == before, "the protected pages were evicted instead of page 2");
+        bm.fetchPage(6);                    // Policy frames 4 and 5 are pinned: the tier gives up page 3
+        expect(bm.stats().protectedFrames == 1, "eviction did not come from the protected tier");
+        before = misses();
+        bm.fetchPage(1);
+        expect(misses() == before, "the root was evicted before an internal page");
+
+        PageGuard root = bm.pinPage(1);     // Now every frame but page 6's is pinned...
+        PageGuard six = bm.pinPage(6);      // ...and then that one too
+        bool threw = false;
+        try {
+            bm.fetchPage(2);
+        } catch (const runtime_error&) {
+            threw = true;
+        }
+        expect(threw, "a page was loaded over a pinned frame");
+    }
+    cout << "protected tier demotion and eviction: ok" << endl;
+}
+
+// Writer settings that clean the whole pool every millisecond
+static EngineConfig writerConfig(size_t frames) {
+    EngineConfig config;
+    config.truncate = true;
+    config.bufferFrames = frames;
+    config.backgroundWriter = true;
+    config.writerDelayMs = 1;
+    config.writerLookahead = 1.0;
+    return config;
+}
+
+static void fillPage(char* data, int pageSize, int pageID, int version) {
+    for (int i = 0; i < pageSize / (int)sizeof(int); i++) ((int*)data)[i] = pageID * 1000 + version + i;
+}
+
+// Reopens the file without a writer and checks every page 1..pages against 'versions'
+static void checkPages(int pages, const vector<int>& versions) {
+    EngineConfig config;
+    config.bufferFrames = 8;
+    StorageManager sm(DB_FILE, config);
+    BufferManager bm(sm, config);
+    vector<char> expected(bm.getPageSize());
+    for (int pageID = 1; pageID <= pages; pageID++) {
+        fillPage(expected.data(), bm.getPageSize(), pageID, versions[pageID]);
+        expect(memcmp(bm.fetchPage(pageID), expected.data(), bm.getPageSize()) == 0,
+               "page " + to_string(pageID) + " lost its last version across a reopen");
+    }
+}
+
+// Writes 'version' of a page through a pin and marks it dirty afterwards. A new page counts
+// too: allocatePage() leaves it dirty but unpinned, and the writer may clean it before the pin.
+static void rewrite(BufferManager& bm, int pageID, int version) {
+    PageGuard page = bm.pinPage(pageID);
+    fillPage(page.get(), bm.getPageSize(), pageID, version);
+    page.markDirty();
+}
+
+// Runs 'step' with the file limited to 'pages' pages: a real write error, as pwrite past
+// them fails with EFBIG
+static void withSizeLimit(int pages, int pageSize, const function<void()>& step) {
+    signal(SIGXFSZ, SIG_IGN);               // pwrite returns EFBIG instead of killing the process
+    rlimit old;
+    getrlimit(RLIMIT_FSIZE, &old);
+    rlimit limited = old;
+    limited.rlim_cur = (rlim_t)pages * pageSize;
+    setrlimit(RLIMIT_FSIZE, &limited);
+    try {
+        step();
+    } catch (...) {
+        setrlimit(RLIMIT_FSIZE, &old);
+        throw;
+    }
+    setrlimit(RLIMIT_FSIZE, &old);
+}
+
+// An eviction whose write-back fails must leave its page resident, dirty and under the
+// policy, and a miss whose read fails must leave its frame free for the next miss. On a
+// 2-frame pool holding two dirty pages, a file size limit fails every victim's write; once
+// it is lifted, both frames must be reclaimable again and the unwritten versions reach disk.
+static void failedEviction() {
+    const int PAGES = 6;
+    for (Replacement kind : POLICIES) {
+        vector<int> versions(PAGES + 1, 1);
+        {
+            EngineConfig config;
+            config.truncate = true;
+            config.bufferFrames = 2;
+            config.protectedShare = 0;
+            config.replacement = kind;
+            StorageManager sm(DB_FILE, config);
+            BufferManager bm(sm, config);
+            string name = bm.policyName();
+            for (int i = 0; i < PAGES; i++) rewrite(bm, bm.allocatePage(), 1);
+            bm.checkpoint();
+            for (int pageID = 1; pageID <= PAGES; pageID++) // Both pages left resident are dirty
+                rewrite(bm, pageID, ++versions[pageID]);
+
+            vector<int> missing;            // Pages the last round could not load
+            withSizeLimit(1, bm.getPageSize(), [&] { // Only the header fits
+                for (int round = 0; round < 3; round++) {
+                    missing.clear();
+                    for (int pageID = 1; pageID <= PAGES; pageID++) {
+                        try {
+                            bm.fetchPage(pageID);
+                        } catch (const runtime_error&) {
+                            missing.push_back(pageID);
+                        }
+                    }
+                    expect(missing.size() == PAGES - 2, name + " loaded " + to_string(PAGES - missing.size()) +
+                           " pages into 2 frames whose write-back fails");
+                }
+            });
+            {
+                PageGuard a = bm.pinPage(missing[0]); // Both frames must be reclaimable
+                PageGuard b = bm.pinPage(missing[1]);
+            }
+
+            bool threw = false;
+            try {
+                bm.fetchPage(-2);           // A negative offset makes pread fail with EINVAL
+            } catch (const runtime_error&) {
+                threw = true;
+            }
+            expect(threw, "a read at a negative offset succeeded");
+            long evictions = bm.stats().evictions;
+            PageGuard a = bm.pinPage(missing[2]);
+            expect(bm.stats().evictions == evictions, name + " evicted a page while a frame was empty");
+            PageGuard b = bm.pinPage(missing[3]);
+            a.release();
+            b.release();
+            bm.checkpoint();
+        }
+        checkPages(PAGES, versions);
+    }
+    cout << "failed eviction writes and reads: ok" << endl;
+}
+
+static bool waitFor(BufferManager& bm, bool (*done)(const BufferStats&)) { // Up to 5 seconds
+    for (int i = 0; i < 5000 && !done(bm.stats()); i++) this_thread::sleep_for(chrono::milliseconds(1));
+    return done(bm.stats());
+}
+
+// Pages rewritten while the writer cleans them, in a pool smaller than the file, so frames
+// move between the writer, eviction and new changes; after checkpoint() every page must
+// reopen with its last version
+static void writerDurability(unsigned seed) {
+    const int PAGES = 200;
+    vector<int> versions(PAGES + 1, 0);
+    {
+        EngineConfig config = writerConfig(64);
+        StorageManager sm(DB_FILE, config);
+        BufferManager bm(sm, config);
+        mt19937 rng(seed);
+        for (int i = 0; i < PAGES; i++) rewrite(bm, bm.allocatePage(), 0);
+        for (int i = 0; i < 5000; i++) {
+            int pageID = 1 + rng() % PAGES;
+            rewrite(bm, pageID, ++versions[pageID]);
+            if (i % 500 == 0) this_thread::sleep_for(chrono::milliseconds(3)); // Let the writer run
+        }
+        expect(waitFor(bm, [](const BufferStats& s) { return s.backgroundWrites > 0; }), "the writer never ran");
+        bm.checkpoint();
+        expect(!bm.stats().writerFailed, "the writer failed without an I/O error");
+    }
+    checkPages(PAGES, versions);
+    cout << "background writer durability: ok" << endl;
+}
+
+// A write error in the writer thread must surface in the next checkpoint() instead of being
+// lost, and the frames it could not write must stay dirty. The pool is smaller than the set
+// of dirty pages, so once the writer has stopped, foreground evictions meet the same error;
+// the pool must survive them, and after the limit is lifted every last version reaches disk.
+static void writerFailure() {
+    const int PAGES = 20;
+    const int LIMIT_PAGES = 4;              // Header and pages 1..3 still fit
+    vector<int> versions(PAGES + 1, 1);
+    {
+        EngineConfig config = writerConfig(8);
+        StorageManager sm(DB_FILE, config);
+        BufferManager bm(sm, config);
+        for (int i = 0; i < PAGES; i++) rewrite(bm, bm.allocatePage(), 1);
+        bm.checkpoint();
+        auto rewriteAll = [&] {             // Pages whose eviction write failed keep their version
+            int failed = 0;
+            for (int pageID = 1; pageID <= PAGES; pageID++) {
+                try {
+                    rewrite(bm, pageID, versions[pageID] + 1);
+                    versions[pageID]++;
+                } catch (const runtime_error&) {
+                    failed++;
+                }
+            }
+            return failed;
+        };
+        withSizeLimit(LIMIT_PAGES, bm.getPageSize(), [&] {
+            rewriteAll();
+            expect(waitFor(bm, [](const BufferStats& s) { return s.writerFailed; }), "the writer never hit the size limit");
+            bool reported = false;
+            try {
+                bm.checkpoint();
+            } catch (const runtime_error& e) {
+                reported = string(e.what()).find("background writer stopped") != string::npos;
+            }
+            expect(reported, "checkpoint() did not report the writer's error");
+            int failed = 0;
+            for (int round = 0; round < 3; round++) failed += rewriteAll(); // Evictions write themselves
+            expect(failed > 0, "evictions wrote past the file size limit");
+            bool threw = false;
+            try {
+                bm.checkpoint();            // No writer now: the foreground write fails itself
+            } catch (const runtime_error&) {
+                threw = true;
+            }
+            expect(threw, "checkpoint() succeeded past the file size limit");
+        });
+        expect(rewriteAll() == 0, "a frame was lost to a failed eviction");
+        bm.checkpoint();                    // The unwritten frames were kept dirty
+        expect(bm.stats().writerFailed, "writerFailed was cleared");
+    }
+    checkPages(PAGES, versions);
+    cout << "background writer failure: ok" << endl;
+}
+
+int main(int argc, char** argv) {
+    unsigned seed = argc > 1 ? atoi(argv[1]) : 1;
+    try {
+        allPinned();
+        scanResistance();
+        arcAdapts();
+        ghostHistory(seed);
+        rootSurvivesScan();
+        protectedTier();
+        writerDurability(seed);
+        writerFailure();
+        failedEviction();
+    } catch (const exception& e) {
+        cout << "FAILED (seed " << seed << "): " << e.what() << endl;
+        remove(DB_FILE);
+        return 1;
+    }
+    remove(DB_FILE);
+    cout << "All buffer pool checks passed." << endl;
+    return 0;
+}
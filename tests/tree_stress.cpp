@@ -0,0 +1,329 @@
+#include "../include/ExternalSort.hpp"
+#include <iostream>                         // Progress lines and the failure report
+#include <random>                           // Key streams and operation mix
+#include <map>                              // Reference model of the tree's contents
+#include <climits>                          // INT_MIN/INT_MAX for full scans
+
+// --- B+ TREE STRESS TEST ---
+// Randomized model check: long mixes of insert/put/remove/append run against both the tree
+// and a std::map, and after every batch the whole tree is walked and compared with the
+// model. Covers borrow, merge and root collapse on removal, free-list reuse of merged
+// pages, and bulkLoad() (sorted array, external sort, rollback on unsorted input).
+// Small fanouts keep the tree deep so every rebalance path runs often.
+// Usage: tree_stress [seed]   (default 1)
+
+typedef map<int, int> Model;
+const char* DB_FILE = "stress.db";
+
+static void expect(bool ok, const string& what) {
+    if (!ok) throw runtime_error(what);
+}
+
+// Walks the tree from the root and checks its structure against the model:
+// key order and separator bounds, equal leaf depth, the occupancy bound (only the
+// rightmost node of a level may hold fewer than maxKeys / 2 keys), the leaf chain,
+// and that a full scan returns exactly the model's pairs.
+class TreeChecker {
+    BufferManager& bm;
+    int maxKeys;
+    int leafDepth;
+    vector<int> leaves;            // Leaf PageIDs in key order
+    size_t keys;                   // Keys found in the leaves
+
+    void walk(int pageID, int depth, long lo, long hi, bool rightmost) {
+        vector<int> nodeKeys, children;
+        bool isLeaf;
+        {
+            PageGuard page = bm.pinPage(pageID);
+            BPlusNode* node = page.as<BPlusNode>();
+            isLeaf = node->isLeaf;
+            nodeKeys.assign(node->keys(), node->keys() + node->numKeys);
+            if (!isLeaf) children.assign(node->children(maxKeys), node->children(maxKeys) + node->numKeys + 1);
+        }
+        string where = "page " + to_string(pageID);
+        expect((int)nodeKeys.size() <= maxKeys, where + " overflows");
+        if (depth > 0 && !rightmost)
+            expect((int)nodeKeys.size() >= maxKeys / 2, where + " underflows with " + to_string(nodeKeys.size()) + " keys");
+        if (depth == 0 && !isLeaf) expect(!nodeKeys.empty(), "internal root has a single child");
+        for (size_t i = 0; i < nodeKeys.size(); i++) {
+            expect(nodeKeys[i] >= lo && nodeKeys[i] < hi, where + " holds a key outside its separators");
+            expect(i == 0 || nodeKeys[i - 1] < nodeKeys[i], where + " is out of order");
+        }
+        if (isLeaf) {
+            if (leafDepth == -1) leafDepth = depth;
+            expect(depth == leafDepth, where + " is a leaf at the wrong depth");
+            leaves.push_back(pageID);
+            keys += nodeKeys.size();
+            return;
+        }
+        for (size_t i = 0; i < children.size(); i++)
+            walk(children[i], depth + 1, i ? nodeKeys[i - 1] : lo, i < nodeKeys.size() ? nodeKeys[i] : hi,
+                 rightmost && i + 1 == children.size());
+    }
+
+public:
+    TreeChecker(BufferManager& b, int fanout) : bm(b), maxKeys(fanout) {}
+
+    void check(BPlusTree& tree, const Model& model) {
+        leafDepth = -1;
+        leaves.clear();
+        keys = 0;
+        walk(bm.header().rootPage, 0, LONG_MIN, LONG_MAX, true);
+        expect(keys == model.size(), "tree holds " + to_string(keys) + " keys, model " + to_string(model.size()));
+        for (size_t i = 0; i < leaves.size(); i++) {
+            PageGuard page = bm.pinPage(leaves[i]);
+            int expected = i + 1 < leaves.size() ? leaves[i + 1] : -1;
+            expect(page.as<BPlusNode>()->nextLeaf == expected, "leaf chain broken at page " + to_string(leaves[i]));
+        }
+        Model::const_iterator m = model.begin();
+        for (BPlusTree::Iterator it = tree.scan(INT_MIN, INT_MAX); it.valid(); it.next(), ++m) {
+            expect(m != model.end(), "scan returns more pairs than the model");
+            expect(it.key() == m->first && it.value() == m->second, "scan differs at key " + to_string(m->first));
+        }
+        expect(m == model.end(), "scan returns fewer pairs than the model");
+    }
+};
+
+// Random insert/put/remove rounds plus ascending appends (the append fast path and its
+// one-key rightmost nodes), then removal of every key down to an empty root leaf.
+static void randomOperations(int maxKeys, unsigned seed) {
+    EngineConfig config;
+    config.truncate = true;
+    config.maxKeys = maxKeys;
+    config.bufferFrames = 32;               // Far smaller than the tree: removals run through eviction
+    StorageManager sm(DB_FILE, config);
+    BufferManager bm(sm, config);
+    BPlusTree tree(bm, config);
+    TreeChecker checker(bm, maxKeys);
+    Model model;
+    mt19937 rng(seed);
+    const int N = 4000;
+    int value;
+    for (int round = 0; round < 6; round++) {
+        for (int i = 0; i < N; i++) {       // Random keys: splits in the middle of the tree
+            int key = rng() % (2 * N);
+            value = rng();
+            bool upsert = rng() % 2;
+            bool added = upsert ? tree.put(key, value) : tree.insert(key, value);
+            bool expected = model.count(key) == 0;
+            if (upsert || expected) model[key] = value; // insert() keeps an existing key's value
+            expect(added == expected, "insert of " + to_string(key) + " disagrees with the model");
+        }
+        checker.check(tree, model);
+        int base = model.rbegin()->first + 1;
+        for (int i = 0; i < N; i++) {       // Ascending keys: append splits
+            expect(tree.insert(base + 2 * i, i), "append of " + to_string(base + 2 * i) + " failed");
+            model[base + 2 * i] = i;
+            if (i % 500 == 0) checker.check(tree, model);
+        }
+        checker.check(tree, model);
+        int removals = round % 2 ? 3 * N : N; // Odd rounds shrink the tree: merges and root collapse
+        int range = base + 2 * N;
+        for (int i = 0; i < removals; i++) {
+            int key = rng() % range;
+            bool removed = tree.remove(key);
+            expect(removed == (model.erase(key) == 1), "remove of " + to_string(key) + " disagrees with the model");
+            if (i % 1000 == 0) checker.check(tree, model);
+        }
+        checker.check(tree, model);
+        for (Model::const_iterator m = model.begin(); m != model.end(); ++m)
+            expect(tree.get(m->first, value) && value == m->second, "lost key " + to_string(m->first));
+    }
+    vector<int> rest;
+    for (Model::const_iterator m = model.begin(); m != model.end(); ++m) rest.push_back(m->first);
+    shuffle(rest.begin(), rest.end(), rng);
+    for (size_t i = 0; i < rest.size(); i++) {
+        expect(tree.remove(rest[i]), "remove of " + to_string(rest[i]) + " failed");
+        model.erase(rest[i]);
+        if (i % 1000 == 0) checker.check(tree, model);
+    }
+    checker.check(tree, model);
+    expect(tree.height() == 1, "empty tree did not collapse to a root leaf");
+    cout << "random operations, maxKeys " << maxKeys << ": ok, " << bm.getNextPageID() << " pages, "
+         << bm.getFreePageCount() << " free" << endl;
+}
+
+// Sliding window of keys (oldest removed, newest appended): once the window is full, the
+// pages freed by merges must be reused, so the file stops growing.
+static void freeListReuse() {
+    EngineConfig config;
+    config.truncate = true;
+    config.maxKeys = 8;
+    config.bufferFrames = 64;
+    StorageManager sm(DB_FILE, config);
+    BufferManager bm(sm, config);
+    BPlusTree tree(bm, config);
+    TreeChecker checker(bm, config.maxKeys);
+    Model model;
+    const int WINDOW = 20000;
+    int next = 0;
+    for (; next < WINDOW; next++) {
+        tree.insert(next, next);
+        model[next] = next;
+    }
+    int pages = -1;
+    for (int round = 0; round < 5; round++) {
+        for (int i = 0; i < WINDOW; i++) {
+            int oldest = model.begin()->first;
+            expect(tree.remove(oldest), "remove of " + to_string(oldest) + " failed");
+            model.erase(model.begin());
+            tree.insert(next, next);
+            model[next] = next;
+            next++;
+        }
+        checker.check(tree, model);
+        if (round == 1) pages = bm.getNextPageID();
+        if (round > 1)
+            expect(bm.getNextPageID() == pages, "file grew from " + to_string(pages) + " to " +
+                   to_string(bm.getNextPageID()) + " pages with the free list populated");
+    }
+    bm.checkpoint();
+    int freePages = bm.getFreePageCount();
+    {                                       // The free list survives a reopen
+        StorageManager reopened(DB_FILE);
+        expect(reopened.header().freePages == freePages, "free page count changed across a reopen");
+    }
+    cout << "free-list reuse: ok, " << pages << " pages, " << freePages << " free" << endl;
+}
+
+// The append fast path is decided from the cached maximum of the rightmost leaf: an
+// append that fits touches only that leaf, and an insert elsewhere pays the plain descent,
+// with no extra access to the rightmost leaf.
+static void appendFastPath() {
+    EngineConfig config;
+    config.truncate = true;
+    config.maxKeys = 16;
+    config.bufferFrames = 64;
+    StorageManager sm(DB_FILE, config);
+    BufferManager bm(sm, config);
+    BPlusTree tree(bm, config);
+    vector<int> keys(2000);
+    for (int i = 0; i < 2000; i++) keys[i] = 4 * i;
+    ArraySource source(keys.data(), nullptr, keys.size());
+    tree.bulkLoad(source, 0.5);             // Half-full leaves: most middle inserts fit
+    int height = tree.height();
+    mt19937 rng(5);
+    int checked[2] = {0, 0};                // Appends and middle inserts that did not split
+    bool cached = false;                    // Splits drop the cached path; the next descent restores it
+    for (int k = 8000; k < 8800; k += 4) {
+        for (int kind = 0; kind < 2; kind++) {
+            int key = kind == 0 ? k : 1 + 4 * (rng() % 2000) + rng() % 3; // Append, or a gap in the middle
+            int pages = bm.getNextPageID() - bm.getFreePageCount(); // Pages in use
+            BufferStats before = bm.stats();
+            tree.insert(key, k);
+            BufferStats after = bm.stats();
+            bool split = bm.getNextPageID() - bm.getFreePageCount() != pages;
+            long accesses = after.hits + after.misses - before.hits - before.misses;
+            long expected = kind == 0 ? 1 : height + 1; // The leaf alone, or a descent then the leaf
+            if (!split && (kind == 1 || cached)) {
+                expect(accesses == expected, "insert of " + to_string(key) + " made " + to_string(accesses) +
+                       " buffer accesses instead of " + to_string(expected));
+                checked[kind]++;
+            }
+            cached = kind == 0 || (cached && !split); // Every append leaves the rightmost leaf cached
+            if (split) height = tree.height();
+        }
+    }
+    expect(checked[0] > 100 && checked[1] > 100, "too few inserts without a split");
+    cout << "append fast path: ok" << endl;
+}
+
+// bulkLoad() from a sorted array and from an ExternalSorter fed shuffled input, then
+// random updates on the loaded tree; a load from unsorted input must throw and leave the
+// file and the tree as they were.
+static void bulkLoads(unsigned seed) {
+    mt19937 rng(seed);
+    const int N = 30000;
+    for (int variant = 0; variant < 4; variant++) {
+        EngineConfig config;
+        config.truncate = true;
+        config.maxKeys = 6;
+        config.bufferFrames = 32;
+        StorageManager sm(DB_FILE, config);
+        BufferManager bm(sm, config);
+        BPlusTree tree(bm, config);
+        TreeChecker checker(bm, config.maxKeys);
+        Model model;
+        vector<int> keys, values;
+        for (int i = 0; i < N; i++) {
+            keys.push_back(3 * i - N);
+            values.push_back(rng());
+            model[keys.back()] = values.back();
+        }
+        double fill = variant % 2 ? 0.5 : 1.0;
+        long loaded;
+        if (variant < 2) {
+            ArraySource source(keys.data(), values.data(), keys.size());
+            loaded = tree.bulkLoad(source, fill);
+        } else {                            // Small runs force a multi-way merge
+            ExternalSorter sorter(N / 7 * 2 * sizeof(int));
+            vector<int> order(N);
+            for (int i = 0; i < N; i++) order[i] = i;
+            shuffle(order.begin(), order.end(), rng);
+            for (int i : order) sorter.add(keys[i], values[i]);
+            loaded = tree.bulkLoad(sorter, fill);
+        }
+        expect(loaded == N, "bulkLoad loaded " + to_string(loaded) + " of " + to_string(N) + " pairs");
+        checker.check(tree, model);
+        for (int i = 0; i < N; i++) {
+            int key = rng() % (4 * N) - N;
+            if (rng() % 2) {
+                int value = rng();
+                tree.put(key, value);
+                model[key] = value;
+            } else {
+                expect(tree.remove(key) == (model.erase(key) == 1), "remove of " + to_string(key) + " disagrees with the model");
+            }
+        }
+        checker.check(tree, model);
+    }
+
+    EngineConfig config;
+    config.truncate = true;
+    config.maxKeys = 6;
+    config.bufferFrames = 32;
+    StorageManager sm(DB_FILE, config);
+    BufferManager bm(sm, config);
+    BPlusTree tree(bm, config);
+    TreeChecker checker(bm, config.maxKeys);
+    vector<int> keys(N);
+    for (int i = 0; i < N; i++) keys[i] = i;
+    swap(keys[N - 1], keys[N - 3]);         // Caught only after most pages were appended
+    int pages = bm.getNextPageID();
+    ArraySource source(keys.data(), nullptr, keys.size());
+    bool threw = false;
+    try {
+        tree.bulkLoad(source);
+    } catch (const invalid_argument&) {
+        threw = true;
+    }
+    expect(threw, "bulkLoad accepted unsorted input");
+    expect(bm.getNextPageID() == pages, "failed bulkLoad left " + to_string(bm.getNextPageID() - pages) + " pages behind");
+    Model model;
+    checker.check(tree, model);
+    for (int i = 0; i < 1000; i++) {        // The tree is still empty and usable
+        tree.insert(i, i);
+        model[i] = i;
+    }
+    checker.check(tree, model);
+    cout << "bulk load: ok" << endl;
+}
+
+int main(int argc, char** argv) {
+    unsigned seed = argc > 1 ? atoi(argv[1]) : 1;
+    try {
+        randomOperations(3, seed);          // Fanout 4: the smallest nodes, the deepest tree
+        randomOperations(4, seed + 1);      // Even maxKeys: a different split midpoint
+        randomOperations(7, seed + 2);
+        freeListReuse();
+        appendFastPath();
+        bulkLoads(seed);
+    } catch (const exception& e) {
+        cout << "FAILED (seed " << seed << "): " << e.what() << endl;
+        remove(DB_FILE);
+        return 1;
+    }
+    remove(DB_FILE);
+    cout << "All tree checks passed." << endl;
+    return 0;
+}
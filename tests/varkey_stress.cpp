@@ -0,0 +1,214 @@
+#include "../include/VarKeyTree.hpp"
+#include <iostream>                         // Progress lines and the failure report
+#include <random>                           // Key streams and operation mix
+#include <map>                              // Reference model of the tree's contents
+
+// --- VARIABLE-LENGTH KEY TREE STRESS TEST ---
+// Randomized model check of VarKeyTree: mixes of insert/put/remove run against both the
+// tree and a std::map, and after every batch the whole tree is walked and compared with
+// the model, then random range scans are checked against it. Keys share long prefixes,
+// and later rounds add keys under shorter ones, so nodes built around a long prefix
+// must rebuild with a shorter one (makeRoom) or split, and lookups must route through
+// truncated separators. Runs with and without compression, ends by removing every key
+// (empty nodes dropped, root collapse) and by reopening the file.
+// Usage: varkey_stress [seed]   (default 1)
+
+typedef map<string, int> Model;
+const char* DB_FILE = "varkey_stress.db";
+
+static void expect(bool ok, const string& what) {
+    if (!ok) throw runtime_error(what);
+}
+
+// Prefixes from most to least specific; round r draws keys below the first r + 1 of them
+const char* PREFIXES[] = {
+    "https://shop.example.com/catalog/electronics/computers/laptops/",
+    "https://shop.example.com/catalog/electronics/computers/",
+    "https://shop.example.com/catalog/electronics/phones/",
+    "https://shop.example.com/catalog/",
+    "https://shop.example.org/",
+    "",
+};
+const int PREFIX_COUNT = sizeof(PREFIXES) / sizeof(PREFIXES[0]);
+
+class KeyGenerator {
+    mt19937& rng;
+
+public:
+    KeyGenerator(mt19937& r) : rng(r) {}
+
+    string next(int prefixes) {
+        string key = PREFIXES[rng() % prefixes];
+        switch (rng() % 8) {
+            case 0: break;                  // The bare prefix: a prefix of every other key below it
+            case 1: key += string(1 + rng() % 600, 'a' + rng() % 3); break; // Long run: few keys per page
+            case 2:                         // Arbitrary bytes, including 0x00 and 0xff
+                for (int i = 1 + rng() % 6; i > 0; i--) key += (char)(rng() % 256);
+                break;
+            default:                        // Item ids: short distinguishing suffixes
+                key += "item-" + to_string(rng() % 5000);
+                if (rng() % 2) key += "/reviews";
+        }
+        return key;
+    }
+};
+
+// Walks the tree from the root and checks its structure against the model: key order and
+// separator bounds, equal leaf depth, no empty node below the root, the leaf chain, that
+// every page is either in the tree or on the free list, and that a full scan returns
+// exactly the model's pairs.
+class TreeChecker {
+    BufferManager& bm;
+    VarKeyTree& tree;
+    int leafDepth;
+    vector<int> leaves;            // Leaf PageIDs in key order
+    size_t keys;                   // Keys found in the leaves
+    int pages;                     // Nodes reachable from the root
+
+    // Keys of the node must lie in [lo, hi); an empty 'hi' with 'unbounded' set means no limit
+    void walk(int pageID, int depth, const string& lo, const string& hi, bool unbounded) {
+        vector<string> nodeKeys;
+        vector<int> children;
+        bool isLeaf;
+        {
+            PageGuard page = bm.pinPage(pageID);
+            SlottedNode* node = page.as<SlottedNode>();
+            isLeaf = node->isLeaf;
+            expect(node->freeSpace() >= 0, "page " + to_string(pageID) + " overlaps its slots and heap");
+            for (int i = 0; i < node->numKeys; i++) nodeKeys.push_back(tree.keyOf(node, i));
+            if (!isLeaf)
+                for (int i = 0; i <= node->numKeys; i++) children.push_back(node->child(i));
+        }
+        pages++;
+        string where = "page " + to_string(pageID);
+        if (depth > 0 && isLeaf) expect(!nodeKeys.empty(), where + " is an empty leaf below the root");
+        if (depth == 0 && !isLeaf) expect(!nodeKeys.empty(), "internal root has a single child");
+        for (size_t i = 0; i < nodeKeys.size(); i++) {
+            expect(nodeKeys[i] >= lo && (unbounded || nodeKeys[i] < hi), where + " holds a key outside its separators");
+            expect(i == 0 || nodeKeys[i - 1] < nodeKeys[i], where + " is out of order");
+        }
+        if (isLeaf) {
+            if (leafDepth == -1) leafDepth = depth;
+            expect(depth == leafDepth, where + " is a leaf at the wrong depth");
+            leaves.push_back(pageID);
+            keys += nodeKeys.size();
+            return;
+        }
+        for (size_t i = 0; i < children.size(); i++) {
+            bool last = i == nodeKeys.size();
+            walk(children[i], depth + 1, i ? nodeKeys[i - 1] : lo, last ? hi : nodeKeys[i], last && unbounded);
+        }
+    }
+
+public:
+    TreeChecker(BufferManager& b, VarKeyTree& t) : bm(b), tree(t) {}
+
+    void check(const Model& model) {
+        leafDepth = -1;
+        leaves.clear();
+        keys = 0;
+        pages = 0;
+        walk(bm.header().rootPage, 0, "", "", true);
+        expect(keys == model.size(), "tree holds " + to_string(keys) + " keys, model " + to_string(model.size()));
+        expect(1 + pages + bm.getFreePageCount() == bm.getNextPageID(), "pages leaked: " + to_string(pages) +
+               " in the tree, " + to_string(bm.getFreePageCount()) + " free, " + to_string(bm.getNextPageID()) + " in the file");
+        for (size_t i = 0; i < leaves.size(); i++) {
+            PageGuard page = bm.pinPage(leaves[i]);
+            int expected = i + 1 < leaves.size() ? leaves[i + 1] : -1;
+            expect(page.as<SlottedNode>()->nextLeaf == expected, "leaf chain broken at page " + to_string(leaves[i]));
+        }
+        checkScan(model, "", string(VarKeyTree::maxKeySize(bm.getPageSize()), '\xff'));
+    }
+
+    // scan(lo, hi) must return the model's pairs with lo <= key <= hi, in order
+    void checkScan(const Model& model, const string& lo, const string& hi) {
+        Model::const_iterator m = model.lower_bound(lo);
+        Model::const_iterator end = model.upper_bound(hi);
+        for (VarKeyTree::Iterator it = tree.scan(lo, hi); it.valid(); it.next(), ++m) {
+            expect(m != end, "scan returns more pairs than the model");
+            expect(it.key() == m->first && it.value() == m->second, "scan differs at a key of length " + to_string(m->first.size()));
+        }
+        expect(m == end, "scan returns fewer pairs than the model");
+    }
+};
+
+static void randomOperations(bool compress, unsigned seed) {
+    EngineConfig config;
+    config.truncate = true;
+    config.compressKeys = compress;
+    config.bufferFrames = 16;               // Far smaller than the tree: every path runs through eviction
+    Model model;
+    mt19937 rng(seed);
+    KeyGenerator keys(rng);
+    int value;
+    {
+        StorageManager sm(DB_FILE, config);
+        BufferManager bm(sm, config);
+        VarKeyTree tree(bm, config);
+        TreeChecker checker(bm, tree);
+        const int N = 3000;
+        for (int round = 0; round < PREFIX_COUNT; round++) {
+            for (int i = 0; i < N; i++) {   // Insert and upsert keys under the prefixes seen so far
+                string key = keys.next(round + 1);
+                value = rng();
+                bool upsert = rng() % 2;
+                bool added = upsert ? tree.put(key, value) : tree.insert(key, value);
+                bool expected = model.count(key) == 0;
+                if (upsert || expected) model[key] = value; // insert() keeps an existing key's value
+                expect(added == expected, "insert disagrees with the model in round " + to_string(round));
+            }
+            checker.check(model);
+            int removals = round % 2 ? 2 * N : N / 2; // Odd rounds empty many leaves
+            for (int i = 0; i < removals; i++) {
+                string key = rng() % 2 && !model.empty() ? next(model.begin(), rng() % model.size())->first
+                                                         : keys.next(round + 1);
+                bool removed = tree.remove(key);
+                expect(removed == (model.erase(key) == 1), "remove disagrees with the model in round " + to_string(round));
+                if (i % 1000 == 0) checker.check(model);
+            }
+            checker.check(model);
+            for (int i = 0; i < 50; i++) {  // Ranges that start and end between stored keys
+                string lo = keys.next(PREFIX_COUNT), hi = keys.next(PREFIX_COUNT);
+                if (hi < lo) swap(lo, hi);
+                checker.checkScan(model, lo, hi);
+            }
+            for (Model::const_iterator m = model.begin(); m != model.end(); ++m)
+                expect(tree.get(m->first, value) && value == m->second, "lost a key of length " + to_string(m->first.size()));
+        }
+        bm.checkpoint();
+    }
+
+    config.truncate = false;                // Reopen the same file
+    StorageManager sm(DB_FILE, config);
+    BufferManager bm(sm, config);
+    VarKeyTree tree(bm, config);
+    TreeChecker checker(bm, tree);
+    checker.check(model);
+    vector<string> rest;
+    for (Model::const_iterator m = model.begin(); m != model.end(); ++m) rest.push_back(m->first);
+    shuffle(rest.begin(), rest.end(), rng);
+    for (size_t i = 0; i < rest.size(); i++) {
+        expect(tree.remove(rest[i]), "remove of a stored key failed");
+        model.erase(rest[i]);
+        if (i % 1000 == 0) checker.check(model);
+    }
+    checker.check(model);
+    expect(tree.height() == 1, "empty tree did not collapse to a root leaf");
+    cout << "random operations, compressKeys " << (compress ? "on" : "off") << ": ok, " << bm.getNextPageID()
+         << " pages, " << bm.getFreePageCount() << " free" << endl;
+}
+
+int main(int argc, char** argv) {
+    unsigned seed = argc > 1 ? atoi(argv[1]) : 1;
+    try {
+        randomOperations(true, seed);
+        randomOperations(false, seed + 1);
+    } catch (const exception& e) {
+        cout << "FAILED (seed " << seed << "): " << e.what() << endl;
+        remove(DB_FILE);
+        return 1;
+    }
+    remove(DB_FILE);
+    cout << "All variable-length key tree checks passed." << endl;
+    return 0;
+}